@@ -128,6 +128,24 @@ void Database::insertMediaEncryptedKeys(qint64 mediaId, const QByteArray &key, c
     QMetaObject::invokeMethod(p->core, "insertMediaEncryptedKeys", Qt::QueuedConnection, Q_ARG(qint64,mediaId), Q_ARG(QByteArray,key), Q_ARG(QByteArray,iv));
 }
 
+void Database::insertChatFull(const ChatFull &chatFull)
+{
+    FIRST_CHECK;
+    DbChatFull dchatFull;
+    dchatFull.chatFull = chatFull;
+
+    QMetaObject::invokeMethod(p->core, "insertChatFull", Qt::QueuedConnection, Q_ARG(DbChatFull,dchatFull));
+}
+
+void Database::insertStickers(const MessagesAllStickers &stickers)
+{
+    FIRST_CHECK;
+    DbAllStickers dstickers;
+    dstickers.stickers = stickers;
+
+    QMetaObject::invokeMethod(p->core, "insertStickers", Qt::QueuedConnection, Q_ARG(DbAllStickers,dstickers));
+}
+
 void Database::updateUnreadCount(qint64 chatId, int unreadCount)
 {
     FIRST_CHECK;
@@ -140,6 +158,17 @@ void Database::readFullDialogs()
     QMetaObject::invokeMethod(p->core, "readFullDialogs", Qt::QueuedConnection);
 }
 
+void Database::readStickers()
+{
+    if(!p->core)
+    {
+        Q_EMIT stickersFounded(MessagesAllStickers());
+        return;
+    }
+
+    QMetaObject::invokeMethod(p->core, "readStickers", Qt::QueuedConnection);
+}
+
 void Database::markMessagesAsReadFromMaxDate(qint32 chatId, qint32 maxDate)
 {
     FIRST_CHECK;
@@ -161,6 +190,54 @@ void Database::readMessages(const Peer &peer, int offset, int limit)
     QMetaObject::invokeMethod(p->core, "readMessages", Qt::QueuedConnection, Q_ARG(DbPeer,dpeer), Q_ARG(int,offset), Q_ARG(int,limit) );
 }
 
+void Database::readMessagesFrom(const Peer &peer, qint64 fromId, bool newer, int limit)
+{
+    FIRST_CHECK;
+    DbPeer dpeer;
+    dpeer.peer = peer;
+
+    QMetaObject::invokeMethod(p->core, "readMessagesFrom", Qt::QueuedConnection, Q_ARG(DbPeer,dpeer), Q_ARG(qint64,fromId), Q_ARG(bool,newer), Q_ARG(int,limit) );
+}
+
+void Database::readMedia(const Peer &peer, const QList<qint32> &mediaTypes, qint64 maxId, int limit)
+{
+    FIRST_CHECK;
+    DbPeer dpeer;
+    dpeer.peer = peer;
+
+    QMetaObject::invokeMethod(p->core, "readMedia", Qt::QueuedConnection, Q_ARG(DbPeer,dpeer), Q_ARG(QList<qint32>,mediaTypes), Q_ARG(qint64,maxId), Q_ARG(int,limit) );
+}
+
+void Database::readMediaCounts(const Peer &peer, const QList<qint32> &mediaTypes)
+{
+    FIRST_CHECK;
+    DbPeer dpeer;
+    dpeer.peer = peer;
+
+    QMetaObject::invokeMethod(p->core, "readMediaCounts", Qt::QueuedConnection, Q_ARG(DbPeer,dpeer), Q_ARG(QList<qint32>,mediaTypes) );
+}
+
+void Database::searchMessages(const Peer &peer, const QString &keyword, qint64 maxId, int limit)
+{
+    FIRST_CHECK;
+    DbPeer dpeer;
+    dpeer.peer = peer;
+
+    QMetaObject::invokeMethod(p->core, "searchMessages", Qt::QueuedConnection, Q_ARG(DbPeer,dpeer), Q_ARG(QString,keyword), Q_ARG(qint64,maxId), Q_ARG(int,limit) );
+}
+
+void Database::fetchMissing(const QList<qint32> &messages, const QList<qint32> &users, const QList<qint32> &chats)
+{
+    if(!p->core)
+    {
+        Q_EMIT missingFetched(messages, users, chats);
+        return;
+    }
+
+    QMetaObject::invokeMethod(p->core, "fetchMissing", Qt::QueuedConnection, Q_ARG(QList<qint32>, messages),
+                              Q_ARG(QList<qint32>, users), Q_ARG(QList<qint32>, chats));
+}
+
 void Database::deleteMessage(qint64 msgId)
 {
     FIRST_CHECK;
@@ -179,6 +256,12 @@ void Database::deleteHistory(qint64 dlgId)
     QMetaObject::invokeMethod(p->core, "deleteHistory", Qt::QueuedConnection, Q_ARG(qint64,dlgId));
 }
 
+void Database::deleteContact(qint64 userId)
+{
+    FIRST_CHECK;
+    QMetaObject::invokeMethod(p->core, "deleteContact", Qt::QueuedConnection, Q_ARG(qint64, userId));
+}
+
 void Database::blockUser(qint64 userId)
 {
     FIRST_CHECK;
@@ -191,6 +274,12 @@ void Database::unblockUser(qint64 userId)
     QMetaObject::invokeMethod(p->core, "unblockUser", Qt::QueuedConnection, Q_ARG(qint64, userId));
 }
 
+void Database::setValue(const QString &key, const QString &value)
+{
+    FIRST_CHECK;
+    QMetaObject::invokeMethod(p->core, "setValue", Qt::QueuedConnection, Q_ARG(QString, key), Q_ARG(QString, value));
+}
+
 void Database::userFounded_slt(const DbUser &user)
 {
     Q_EMIT userFounded(user.user);
@@ -216,6 +305,31 @@ void Database::contactFounded_slt(const DbContact &contact)
     Q_EMIT contactFounded(contact.contact);
 }
 
+void Database::chatFullFounded_slt(const DbChatFull &chatFull, qint64 updated)
+{
+    Q_EMIT chatFullFounded(chatFull.chatFull, updated);
+}
+
+void Database::stickersFounded_slt(const DbAllStickers &stickers)
+{
+    Q_EMIT stickersFounded(stickers.stickers);
+}
+
+void Database::mediaFounded_slt(const DbPeer &peer, const QList<qint32> &mediaTypes, qint64 maxId, const QList<qint32> &messages)
+{
+    Q_EMIT mediaFounded(peer.peer, mediaTypes, maxId, messages);
+}
+
+void Database::mediaCountsFounded_slt(const DbPeer &peer, const QList<qint32> &mediaTypes, const QList<qint32> &counts)
+{
+    Q_EMIT mediaCountsFounded(peer.peer, mediaTypes, counts);
+}
+
+void Database::messagesSearched_slt(const DbPeer &peer, const QString &keyword, qint64 maxId, const QList<qint32> &messages)
+{
+    Q_EMIT messagesSearched(peer.peer, keyword, maxId, messages);
+}
+
 void Database::refresh()
 {
     if(p->core && p->thread)
@@ -253,8 +367,20 @@ void Database::refresh()
     connect(p->core, SIGNAL(dialogFounded(DbDialog,bool)), SLOT(dialogFounded_slt(DbDialog,bool)), Qt::QueuedConnection );
     connect(p->core, SIGNAL(messageFounded(DbMessage))   , SLOT(messageFounded_slt(DbMessage))   , Qt::QueuedConnection );
     connect(p->core, SIGNAL(contactFounded(DbContact))   , SLOT(contactFounded_slt(DbContact))   , Qt::QueuedConnection );
+    connect(p->core, SIGNAL(chatFullFounded(DbChatFull,qint64)), SLOT(chatFullFounded_slt(DbChatFull,qint64)), Qt::QueuedConnection );
+    connect(p->core, SIGNAL(stickersFounded(DbAllStickers))    , SLOT(stickersFounded_slt(DbAllStickers))    , Qt::QueuedConnection );
     connect(p->core, SIGNAL(mediaKeyFounded(qint64,QByteArray,QByteArray)),
             SIGNAL(mediaKeyFounded(qint64,QByteArray,QByteArray)), Qt::QueuedConnection );
+    connect(p->core, SIGNAL(valueFounded(QString,QString)),
+            SIGNAL(valueFounded(QString,QString)), Qt::QueuedConnection );
+    connect(p->core, SIGNAL(missingFetched(QList<qint32>,QList<qint32>,QList<qint32>)),
+            SIGNAL(missingFetched(QList<qint32>,QList<qint32>,QList<qint32>)), Qt::QueuedConnection );
+    connect(p->core, SIGNAL(mediaFounded(DbPeer,QList<qint32>,qint64,QList<qint32>)),
+            SLOT(mediaFounded_slt(DbPeer,QList<qint32>,qint64,QList<qint32>)), Qt::QueuedConnection );
+    connect(p->core, SIGNAL(mediaCountsFounded(DbPeer,QList<qint32>,QList<qint32>)),
+            SLOT(mediaCountsFounded_slt(DbPeer,QList<qint32>,QList<qint32>)), Qt::QueuedConnection );
+    connect(p->core, SIGNAL(messagesSearched(DbPeer,QString,qint64,QList<qint32>)),
+            SLOT(messagesSearched_slt(DbPeer,QString,qint64,QList<qint32>)), Qt::QueuedConnection );
 }
 
 Database::~Database()
@@ -12,11 +12,16 @@ class User;
 class Dialog;
 class Contact;
 class Chat;
+class ChatFull;
+class MessagesAllStickers;
 class DbUser;
 class DbDialog;
 class DbMessage;
 class DbContact;
 class DbChat;
+class DbChatFull;
+class DbAllStickers;
+class DbPeer;
 class DatabasePrivate;
 class TELEGRAMQMLSHARED_EXPORT Database : public QObject
 {
@@ -44,11 +49,19 @@ public Q_SLOTS:
     void insertContact(const Contact &contact);
     void insertMessage(const Message &message, bool encrypted);
     void insertMediaEncryptedKeys(qint64 mediaId, const QByteArray &key, const QByteArray &iv);
+    void insertChatFull(const ChatFull &chatFull);
+    void insertStickers(const MessagesAllStickers &stickers);
 
     void updateUnreadCount(qint64 chatId, int unreadCount);
 
     void readFullDialogs();
     void readMessages(const Peer &peer, int offset, int limit);
+    void readMessagesFrom(const Peer &peer, qint64 fromId, bool newer, int limit);
+    void readMedia(const Peer &peer, const QList<qint32> &mediaTypes, qint64 maxId, int limit);
+    void readMediaCounts(const Peer &peer, const QList<qint32> &mediaTypes);
+    void searchMessages(const Peer &peer, const QString &keyword, qint64 maxId, int limit);
+    void readStickers();
+    void fetchMissing(const QList<qint32> &messages, const QList<qint32> &users, const QList<qint32> &chats);
     void markMessagesAsRead(const QList<qint32>& messages);
     void markMessagesAsReadFromMaxDate(qint32 chatId, qint32 maxDate);
 
@@ -56,16 +69,27 @@ public Q_SLOTS:
     void deleteDialog(qint64 dlgId);
     void deleteHistory(qint64 dlgId);
 
+    void deleteContact(qint64 userId);
+
     void blockUser(qint64 userId);
     void unblockUser(qint64 userId);
 
+    void setValue(const QString &key, const QString &value);
+
 Q_SIGNALS:
     void userFounded(const User &user);
     void chatFounded(const Chat &chat);
     void dialogFounded(const Dialog &dialog, bool encrypted);
     void contactFounded(const Contact &contact);
     void messageFounded(const Message &message);
+    void chatFullFounded(const ChatFull &chatFull, qint64 updated);
+    void stickersFounded(const MessagesAllStickers &stickers);
     void mediaKeyFounded(qint64 mediaId, const QByteArray &key, const QByteArray &iv);
+    void valueFounded(const QString &key, const QString &value);
+    void missingFetched(const QList<qint32> &messages, const QList<qint32> &users, const QList<qint32> &chats);
+    void mediaFounded(const Peer &peer, const QList<qint32> &mediaTypes, qint64 maxId, const QList<qint32> &messages);
+    void mediaCountsFounded(const Peer &peer, const QList<qint32> &mediaTypes, const QList<qint32> &counts);
+    void messagesSearched(const Peer &peer, const QString &keyword, qint64 maxId, const QList<qint32> &messages);
     void phoneNumberChanged();
     void configPathChanged();
 
@@ -75,6 +99,11 @@ private Q_SLOTS:
     void dialogFounded_slt(const DbDialog &dialog, bool encrypted);
     void messageFounded_slt(const DbMessage &message);
     void contactFounded_slt(const DbContact &contact);
+    void chatFullFounded_slt(const DbChatFull &chatFull, qint64 updated);
+    void stickersFounded_slt(const DbAllStickers &stickers);
+    void mediaFounded_slt(const DbPeer &peer, const QList<qint32> &mediaTypes, qint64 maxId, const QList<qint32> &messages);
+    void mediaCountsFounded_slt(const DbPeer &peer, const QList<qint32> &mediaTypes, const QList<qint32> &counts);
+    void messagesSearched_slt(const DbPeer &peer, const QString &keyword, qint64 maxId, const QList<qint32> &messages);
 
 private:
     void refresh();
@@ -11,6 +11,7 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QUuid>
+#include <QDateTime>
 
 #define ENCRYPTER (p->encrypter?p->encrypter:p->default_encrypter)
 
@@ -53,6 +54,8 @@ DatabaseCore::DatabaseCore(const QString &path, const QString &configPath, const
     qRegisterMetaType<DbContact>("DbContact");
     qRegisterMetaType<DbMessage>("DbMessage");
     qRegisterMetaType<DbPeer>("DbPeer");
+    qRegisterMetaType<DbChatFull>("DbChatFull");
+    qRegisterMetaType<DbAllStickers>("DbAllStickers");
 }
 
 void DatabaseCore::setEncrypter(DatabaseAbstractEncryptor *encrypter)
@@ -274,6 +277,137 @@ void DatabaseCore::insertMediaEncryptedKeys(qint64 mediaId, const QByteArray &ke
     }
 }
 
+void DatabaseCore::insertChatFull(const DbChatFull &dchatFull)
+{
+    begin();
+    const ChatFull &chatFull = dchatFull.chatFull;
+    const ChatParticipants &participants = chatFull.participants();
+    const PeerNotifySettings &notify = chatFull.notifySettings();
+
+    QSqlQuery query(p->db);
+    query.prepare("INSERT OR REPLACE INTO ChatFulls (id, adminId, version, participantsType, photoId, "
+                  "notifyMuteUntil, notifyEventsMask, notifySound, notifyShowPreviews, notifyType, type, updated) "
+                  "VALUES (:id, :adminId, :version, :participantsType, :photoId, "
+                  ":notifyMuteUntil, :notifyEventsMask, :notifySound, :notifyShowPreviews, :notifyType, :type, :updated);");
+
+    query.bindValue(":id", chatFull.id());
+    query.bindValue(":adminId", participants.adminId());
+    query.bindValue(":version", participants.version());
+    query.bindValue(":participantsType", participants.classType());
+    query.bindValue(":photoId", chatFull.chatPhoto().id());
+    query.bindValue(":notifyMuteUntil", notify.muteUntil());
+    query.bindValue(":notifyEventsMask", notify.eventsMask());
+    query.bindValue(":notifySound", notify.sound());
+    query.bindValue(":notifyShowPreviews", notify.showPreviews());
+    query.bindValue(":notifyType", notify.classType());
+    query.bindValue(":type", chatFull.classType());
+    query.bindValue(":updated", QDateTime::currentDateTime().toTime_t());
+
+    bool res = query.exec();
+    if(!res)
+    {
+        qDebug() << __FUNCTION__ << query.lastError();
+        return;
+    }
+
+    insertPhoto(chatFull.chatPhoto());
+
+    QSqlQuery deleteQuery(p->db);
+    deleteQuery.prepare("DELETE FROM ChatParticipants WHERE chatId=:chatId");
+    deleteQuery.bindValue(":chatId", chatFull.id());
+    if(!deleteQuery.exec())
+        qDebug() << __FUNCTION__ << deleteQuery.lastError();
+
+    QSqlQuery participantQuery(p->db);
+    participantQuery.prepare("INSERT OR REPLACE INTO ChatParticipants (chatId, userId, inviterId, date, type) "
+                             "VALUES (:chatId, :userId, :inviterId, :date, :type);");
+
+    Q_FOREACH(const ChatParticipant &participant, participants.participants())
+    {
+        participantQuery.bindValue(":chatId", chatFull.id());
+        participantQuery.bindValue(":userId", participant.userId());
+        participantQuery.bindValue(":inviterId", participant.inviterId());
+        participantQuery.bindValue(":date", participant.date());
+        participantQuery.bindValue(":type", participant.classType());
+
+        if(!participantQuery.exec())
+            qDebug() << __FUNCTION__ << participantQuery.lastError();
+    }
+}
+
+void DatabaseCore::insertStickers(const DbAllStickers &dstickers)
+{
+    begin();
+    const MessagesAllStickers &stickers = dstickers.stickers;
+
+    /*! It's always the whole installed collection, so replace the old one !*/
+    const QStringList tables = QStringList() << "StickerSets" << "StickerPacks" << "StickerDocuments";
+    Q_FOREACH(const QString &table, tables)
+    {
+        QSqlQuery query(p->db);
+        query.prepare("DELETE FROM " + table);
+        if(!query.exec())
+            qDebug() << __FUNCTION__ << query.lastError();
+    }
+
+    QSqlQuery setQuery(p->db);
+    setQuery.prepare("INSERT OR REPLACE INTO StickerSets (id, accessHash, title, shortName, type) "
+                     "VALUES (:id, :accessHash, :title, :shortName, :type);");
+    Q_FOREACH(const StickerSet &set, stickers.sets())
+    {
+        setQuery.bindValue(":id", set.id());
+        setQuery.bindValue(":accessHash", set.accessHash());
+        setQuery.bindValue(":title", set.title());
+        setQuery.bindValue(":shortName", set.shortName());
+        setQuery.bindValue(":type", set.classType());
+
+        if(!setQuery.exec())
+            qDebug() << __FUNCTION__ << setQuery.lastError();
+    }
+
+    QSqlQuery packQuery(p->db);
+    packQuery.prepare("INSERT OR REPLACE INTO StickerPacks (emoticon, documents) VALUES (:emoticon, :documents);");
+    Q_FOREACH(const StickerPack &pack, stickers.packs())
+    {
+        QStringList documents;
+        Q_FOREACH(qint64 docId, pack.documents())
+            documents << QString::number(docId);
+
+        packQuery.bindValue(":emoticon", pack.emoticon());
+        packQuery.bindValue(":documents", documents.join(","));
+
+        if(!packQuery.exec())
+            qDebug() << __FUNCTION__ << packQuery.lastError();
+    }
+
+    QSqlQuery docQuery(p->db);
+    docQuery.prepare("INSERT OR REPLACE INTO StickerDocuments (id, alt, setId, setAccessHash, setShortName, setType) "
+                     "VALUES (:id, :alt, :setId, :setAccessHash, :setShortName, :setType);");
+    Q_FOREACH(const Document &document, stickers.documents())
+    {
+        insertDocument(document);
+
+        Q_FOREACH(const DocumentAttribute &attr, document.attributes())
+        {
+            if(attr.classType() != DocumentAttribute::typeDocumentAttributeSticker)
+                continue;
+
+            const InputStickerSet &set = attr.stickerset();
+            docQuery.bindValue(":id", document.id());
+            docQuery.bindValue(":alt", attr.alt());
+            docQuery.bindValue(":setId", set.id());
+            docQuery.bindValue(":setAccessHash", set.accessHash());
+            docQuery.bindValue(":setShortName", set.shortName());
+            docQuery.bindValue(":setType", set.classType());
+
+            if(!docQuery.exec())
+                qDebug() << __FUNCTION__ << docQuery.lastError();
+        }
+    }
+
+    setValue(DATABASE_STICKERS_HASH_KEY, stickers.hash());
+}
+
 void DatabaseCore::updateUnreadCount(qint64 chatId, int unreadCount)
 {
     begin();
@@ -295,6 +429,7 @@ void DatabaseCore::readFullDialogs()
     readUsers();
     readChats();
     readContacts();
+    readChatFulls();
     readDialogs();
 }
 
@@ -345,6 +480,205 @@ void DatabaseCore::readMessages(const DbPeer &dpeer, int offset, int limit)
         return;
     }
 
+    readMessages(query);
+}
+
+/*! Reads a page of messages right after (newer) or before (older) fromId,
+ *  fromId itself excluded. !*/
+void DatabaseCore::readMessagesFrom(const DbPeer &dpeer, qint64 fromId, bool newer, int limit)
+{
+    const Peer & peer = dpeer.peer;
+    const QString range = newer? "id>:fromId ORDER BY id ASC" : "id<:fromId ORDER BY id DESC";
+
+    QSqlQuery query(p->db);
+    if( peer.classType() == Peer::typePeerChat )
+        query.prepare("SELECT * FROM Messages WHERE toId=:chatId AND toPeerType=:toPeerType AND " + range + " LIMIT :limit");
+    else
+        query.prepare("SELECT * FROM Messages WHERE toPeerType=:toPeerType AND "
+                      "( (toId=:userId AND out=1) OR (fromId=:userId AND out=0) ) AND " + range + " LIMIT :limit");
+
+    query.bindValue(":userId", peer.userId());
+    query.bindValue(":chatId", peer.chatId());
+    query.bindValue(":toPeerType", peer.classType());
+    query.bindValue(":fromId", fromId);
+    query.bindValue(":limit", limit);
+
+    bool res = query.exec();
+    if(!res)
+    {
+        qDebug() << __FUNCTION__ << query.lastError();
+        return;
+    }
+
+    readMessages(query);
+}
+
+/*! Reads a page of media messages older than maxId (0 for the newest
+ *  ones). The messages are sent through messageFounded first and their ids
+ *  follow in mediaFounded, so the receiver can build the page in order. !*/
+void DatabaseCore::readMedia(const DbPeer &dpeer, const QList<qint32> &mediaTypes, qint64 maxId, int limit)
+{
+    const Peer & peer = dpeer.peer;
+    const QString filter = "mediaType IN (" + mediaTypesToString(mediaTypes) + ")" + (maxId? " AND id<:maxId" : "");
+
+    QSqlQuery query(p->db);
+    if( peer.classType() == Peer::typePeerChat )
+        query.prepare("SELECT * FROM Messages WHERE toId=:chatId AND toPeerType=:toPeerType AND " + filter + " ORDER BY id DESC LIMIT :limit");
+    else
+        query.prepare("SELECT * FROM Messages WHERE toPeerType=:toPeerType AND "
+                      "( (toId=:userId AND out=1) OR (fromId=:userId AND out=0) ) AND " + filter + " ORDER BY id DESC LIMIT :limit");
+
+    query.bindValue(":userId", peer.userId());
+    query.bindValue(":chatId", peer.chatId());
+    query.bindValue(":toPeerType", peer.classType());
+    query.bindValue(":maxId", maxId);
+    query.bindValue(":limit", limit);
+
+    bool res = query.exec();
+    if(!res)
+    {
+        qDebug() << __FUNCTION__ << query.lastError();
+        return;
+    }
+
+    const QList<qint32> &messages = readMessages(query);
+    Q_EMIT mediaFounded(dpeer, mediaTypes, maxId, messages);
+}
+
+void DatabaseCore::readMediaCounts(const DbPeer &dpeer, const QList<qint32> &mediaTypes)
+{
+    const Peer & peer = dpeer.peer;
+    const QString filter = "mediaType IN (" + mediaTypesToString(mediaTypes) + ")";
+
+    QSqlQuery query(p->db);
+    if( peer.classType() == Peer::typePeerChat )
+        query.prepare("SELECT mediaType, COUNT(*) FROM Messages WHERE toId=:chatId AND toPeerType=:toPeerType AND " + filter + " GROUP BY mediaType");
+    else
+        query.prepare("SELECT mediaType, COUNT(*) FROM Messages WHERE toPeerType=:toPeerType AND "
+                      "( (toId=:userId AND out=1) OR (fromId=:userId AND out=0) ) AND " + filter + " GROUP BY mediaType");
+
+    query.bindValue(":userId", peer.userId());
+    query.bindValue(":chatId", peer.chatId());
+    query.bindValue(":toPeerType", peer.classType());
+
+    bool res = query.exec();
+    if(!res)
+    {
+        qDebug() << __FUNCTION__ << query.lastError();
+        return;
+    }
+
+    QHash<qint32, qint32> found;
+    while(query.next())
+        found[static_cast<qint32>(query.value(0).toLongLong())] = query.value(1).toInt();
+
+    QList<qint32> counts;
+    Q_FOREACH(qint32 type, mediaTypes)
+        counts << found.value(type);
+
+    Q_EMIT mediaCountsFounded(dpeer, mediaTypes, counts);
+}
+
+/*! Local counterpart of messagesSearch: a page of messages older than
+ *  maxId whose stored text contains keyword. A peer without ids searches
+ *  all dialogs. !*/
+void DatabaseCore::searchMessages(const DbPeer &dpeer, const QString &keyword, qint64 maxId, int limit)
+{
+    const Peer & peer = dpeer.peer;
+
+    QString peerFilter;
+    if( !peer.chatId() && !peer.userId() )
+        peerFilter = "1";
+    else
+    if( peer.classType() == Peer::typePeerChat )
+        peerFilter = "toId=:chatId AND toPeerType=:toPeerType";
+    else
+        peerFilter = "toPeerType=:toPeerType AND ( (toId=:userId AND out=1) OR (fromId=:userId AND out=0) )";
+    if(maxId)
+        peerFilter += " AND id<:maxId";
+
+    /*! A custom encrypter may store the message column as cipher text, so
+     *  LIKE can't see the text. Those rows are decrypted and matched here,
+     *  newest first, until the page is full. !*/
+    QList<qint32> found;
+    if(p->encrypter)
+    {
+        QSqlQuery scan(p->db);
+        scan.prepare("SELECT id, message FROM Messages WHERE " + peerFilter + " ORDER BY id DESC");
+        scan.bindValue(":userId", peer.userId());
+        scan.bindValue(":chatId", peer.chatId());
+        scan.bindValue(":toPeerType", peer.classType());
+        scan.bindValue(":maxId", maxId);
+        if(!scan.exec())
+        {
+            qDebug() << __FUNCTION__ << scan.lastError();
+            return;
+        }
+
+        while(found.count() < limit && scan.next())
+            if(ENCRYPTER->decrypt(scan.value(1)).contains(keyword, Qt::CaseInsensitive))
+                found << scan.value(0).toInt();
+
+        if(found.isEmpty())
+        {
+            Q_EMIT messagesSearched(dpeer, keyword, maxId, found);
+            return;
+        }
+    }
+
+    QSqlQuery query(p->db);
+    if(p->encrypter)
+    {
+        query.prepare("SELECT * FROM Messages WHERE id IN (" + usersToString(found) + ") ORDER BY id DESC");
+    }
+    else
+    {
+        QString pattern = keyword;
+        pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+
+        query.prepare("SELECT * FROM Messages WHERE " + peerFilter + " AND message LIKE :keyword ESCAPE '\\' ORDER BY id DESC LIMIT :limit");
+        query.bindValue(":userId", peer.userId());
+        query.bindValue(":chatId", peer.chatId());
+        query.bindValue(":toPeerType", peer.classType());
+        query.bindValue(":keyword", "%" + pattern + "%");
+        query.bindValue(":maxId", maxId);
+        query.bindValue(":limit", limit);
+    }
+
+    bool res = query.exec();
+    if(!res)
+    {
+        qDebug() << __FUNCTION__ << query.lastError();
+        return;
+    }
+
+    const QList<qint32> &messages = readMessages(query);
+    Q_EMIT messagesSearched(dpeer, keyword, maxId, messages);
+}
+
+void DatabaseCore::fetchMissing(const QList<qint32> &messages, const QList<qint32> &users, const QList<qint32> &chats)
+{
+    if(!users.isEmpty())
+        readUsers(users);
+    if(!chats.isEmpty())
+        readChats(chats);
+    if(!messages.isEmpty())
+    {
+        QSqlQuery query(p->db);
+        query.prepare("SELECT * FROM Messages WHERE id IN (" + usersToString(messages) + ")");
+
+        if(query.exec())
+            readMessages(query);
+        else
+            qDebug() << __FUNCTION__ << query.lastError();
+    }
+
+    Q_EMIT missingFetched(messages, users, chats);
+}
+
+QList<qint32> DatabaseCore::readMessages(QSqlQuery &query)
+{
+    QList<qint32> result;
     while(query.next())
     {
         const QSqlRecord &record = query.record();
@@ -396,11 +730,119 @@ void DatabaseCore::readMessages(const DbPeer &dpeer, int offset, int limit)
         dmsg.message = message;
 
         Q_EMIT messageFounded(dmsg);
+        result << message.id();
 
         const QPair<QByteArray, QByteArray> & keys = readMediaKey(message.id());
         if(!keys.first.isNull())
             Q_EMIT mediaKeyFounded(message.id(), keys.first, keys.second);
     }
+
+    return result;
+}
+
+void DatabaseCore::readStickers()
+{
+    DbAllStickers dstickers;
+    MessagesAllStickers &stickers = dstickers.stickers;
+
+    const QString &hash = value(DATABASE_STICKERS_HASH_KEY);
+    if(hash.isEmpty())
+    {
+        Q_EMIT stickersFounded(dstickers);
+        return;
+    }
+
+    QSqlQuery setQuery(p->db);
+    setQuery.prepare("SELECT * FROM StickerSets");
+    if(!setQuery.exec())
+    {
+        qDebug() << __FUNCTION__ << setQuery.lastError();
+        Q_EMIT stickersFounded(DbAllStickers());
+        return;
+    }
+
+    QList<StickerSet> sets;
+    while(setQuery.next())
+    {
+        const QSqlRecord &record = setQuery.record();
+
+        StickerSet set( static_cast<StickerSet::StickerSetType>(record.value("type").toLongLong()) );
+        set.setId( record.value("id").toLongLong() );
+        set.setAccessHash( record.value("accessHash").toLongLong() );
+        set.setTitle( record.value("title").toString() );
+        set.setShortName( record.value("shortName").toString() );
+
+        sets << set;
+    }
+
+    QSqlQuery packQuery(p->db);
+    packQuery.prepare("SELECT * FROM StickerPacks");
+    if(!packQuery.exec())
+    {
+        qDebug() << __FUNCTION__ << packQuery.lastError();
+        Q_EMIT stickersFounded(DbAllStickers());
+        return;
+    }
+
+    QList<StickerPack> packs;
+    while(packQuery.next())
+    {
+        const QSqlRecord &record = packQuery.record();
+
+        QList<qint64> documents;
+        const QStringList &ids = record.value("documents").toString().split(",", QString::SkipEmptyParts);
+        Q_FOREACH(const QString &id, ids)
+            documents << id.toLongLong();
+
+        StickerPack pack;
+        pack.setEmoticon( record.value("emoticon").toString() );
+        pack.setDocuments(documents);
+
+        packs << pack;
+    }
+
+    QSqlQuery docQuery(p->db);
+    docQuery.prepare("SELECT * FROM StickerDocuments");
+    if(!docQuery.exec())
+    {
+        qDebug() << __FUNCTION__ << docQuery.lastError();
+        Q_EMIT stickersFounded(DbAllStickers());
+        return;
+    }
+
+    QList<Document> documents;
+    while(docQuery.next())
+    {
+        const QSqlRecord &record = docQuery.record();
+
+        Document document = readDocument(record.value("id").toLongLong());
+        if(document.classType() == Document::typeDocumentEmpty)
+            continue;
+
+        InputStickerSet set( static_cast<InputStickerSet::InputStickerSetType>(record.value("setType").toLongLong()) );
+        set.setId( record.value("setId").toLongLong() );
+        set.setAccessHash( record.value("setAccessHash").toLongLong() );
+        set.setShortName( record.value("setShortName").toString() );
+
+        DocumentAttribute sticker(DocumentAttribute::typeDocumentAttributeSticker);
+        sticker.setAlt( record.value("alt").toString() );
+        sticker.setStickerset(set);
+
+        QList<DocumentAttribute> attrs;
+        Q_FOREACH(const DocumentAttribute &attr, document.attributes())
+            if(attr.classType() != DocumentAttribute::typeDocumentAttributeSticker)
+                attrs << attr;
+
+        document.setAttributes( attrs << sticker );
+        documents << document;
+    }
+
+    stickers.setHash(hash);
+    stickers.setSets(sets);
+    stickers.setPacks(packs);
+    stickers.setDocuments(documents);
+
+    Q_EMIT stickersFounded(dstickers);
 }
 
 void DatabaseCore::setValue(const QString &key, const QString &value)
@@ -458,6 +900,18 @@ void DatabaseCore::deleteHistory(qint64 dlgId)
         qDebug() << __FUNCTION__ << query.lastError();
 }
 
+void DatabaseCore::deleteContact(qint64 userId)
+{
+    begin();
+    QSqlQuery query(p->db);
+    query.prepare("DELETE FROM Contacts WHERE userId=:userId");
+    query.bindValue(":userId", userId);
+
+    bool res = query.exec();
+    if(!res)
+        qDebug() << __FUNCTION__ << query.lastError();
+}
+
 void DatabaseCore::blockUser(qint64 userId)
 {
     begin();
@@ -528,10 +982,13 @@ void DatabaseCore::readDialogs()
     }
 }
 
-void DatabaseCore::readUsers()
+void DatabaseCore::readUsers(const QList<qint32> &ids)
 {
     QSqlQuery query(p->db);
-    query.prepare("SELECT * FROM Users");
+    if(ids.isEmpty())
+        query.prepare("SELECT * FROM Users");
+    else
+        query.prepare("SELECT * FROM Users WHERE id IN (" + usersToString(ids) + ")");
 
     bool res = query.exec();
     if(!res)
@@ -588,10 +1045,13 @@ void DatabaseCore::readUsers()
     }
 }
 
-void DatabaseCore::readChats()
+void DatabaseCore::readChats(const QList<qint32> &ids)
 {
     QSqlQuery query(p->db);
-    query.prepare("SELECT * FROM Chats");
+    if(ids.isEmpty())
+        query.prepare("SELECT * FROM Chats");
+    else
+        query.prepare("SELECT * FROM Chats WHERE id IN (" + usersToString(ids) + ")");
 
     bool res = query.exec();
     if(!res)
@@ -677,6 +1137,70 @@ void DatabaseCore::readContacts()
 
         Q_EMIT contactFounded(dcnt);
     }
+
+    Q_EMIT valueFounded(DATABASE_CONTACTS_HASH_KEY, value(DATABASE_CONTACTS_HASH_KEY));
+}
+
+void DatabaseCore::readChatFulls()
+{
+    QSqlQuery query(p->db);
+    query.prepare("SELECT * FROM ChatFulls");
+
+    bool res = query.exec();
+    if(!res)
+    {
+        qDebug() << __FUNCTION__ << query.lastError();
+        return;
+    }
+
+    QSqlQuery participantQuery(p->db);
+    participantQuery.prepare("SELECT * FROM ChatParticipants WHERE chatId=:chatId");
+
+    while(query.next())
+    {
+        const QSqlRecord &record = query.record();
+        const qint64 chatId = record.value("id").toLongLong();
+
+        QList<ChatParticipant> participantsList;
+        participantQuery.bindValue(":chatId", chatId);
+        if(participantQuery.exec())
+            while(participantQuery.next())
+            {
+                const QSqlRecord &precord = participantQuery.record();
+
+                ChatParticipant participant( static_cast<ChatParticipant::ChatParticipantType>(precord.value("type").toLongLong()) );
+                participant.setUserId( precord.value("userId").toLongLong() );
+                participant.setInviterId( precord.value("inviterId").toLongLong() );
+                participant.setDate( precord.value("date").toLongLong() );
+
+                participantsList << participant;
+            }
+        else
+            qDebug() << __FUNCTION__ << participantQuery.lastError();
+
+        ChatParticipants participants( static_cast<ChatParticipants::ChatParticipantsType>(record.value("participantsType").toLongLong()) );
+        participants.setChatId(chatId);
+        participants.setAdminId( record.value("adminId").toLongLong() );
+        participants.setVersion( record.value("version").toLongLong() );
+        participants.setParticipants(participantsList);
+
+        PeerNotifySettings notify( static_cast<PeerNotifySettings::PeerNotifySettingsType>(record.value("notifyType").toLongLong()) );
+        notify.setMuteUntil( record.value("notifyMuteUntil").toLongLong() );
+        notify.setEventsMask( record.value("notifyEventsMask").toLongLong() );
+        notify.setSound( record.value("notifySound").toString() );
+        notify.setShowPreviews( record.value("notifyShowPreviews").toBool() );
+
+        ChatFull chatFull( static_cast<ChatFull::ChatFullType>(record.value("type").toLongLong()) );
+        chatFull.setId(chatId);
+        chatFull.setParticipants(participants);
+        chatFull.setNotifySettings(notify);
+        chatFull.setChatPhoto( readPhoto(record.value("photoId").toLongLong()) );
+
+        DbChatFull dchatFull;
+        dchatFull.chatFull = chatFull;
+
+        Q_EMIT chatFullFounded(dchatFull, record.value("updated").toLongLong());
+    }
 }
 
 void DatabaseCore::reconnect()
@@ -751,6 +1275,79 @@ void DatabaseCore::update_db()
 
         db_version = 5;
     }
+    if (db_version == 5)
+    {
+        QSqlQuery query(p->db);
+        query.prepare("CREATE TABLE IF NOT EXISTS ChatFulls ("
+                      "id BIGINT PRIMARY KEY NOT NULL,"
+                      "adminId BIGINT,"
+                      "version BIGINT,"
+                      "participantsType BIGINT,"
+                      "photoId BIGINT,"
+                      "notifyMuteUntil BIGINT,"
+                      "notifyEventsMask BIGINT,"
+                      "notifySound TEXT,"
+                      "notifyShowPreviews BOOLEAN,"
+                      "notifyType BIGINT,"
+                      "type BIGINT,"
+                      "updated BIGINT)");
+        query.exec();
+
+        QSqlQuery participantsQuery(p->db);
+        participantsQuery.prepare("CREATE TABLE IF NOT EXISTS ChatParticipants ("
+                                  "chatId BIGINT NOT NULL,"
+                                  "userId BIGINT NOT NULL,"
+                                  "inviterId BIGINT,"
+                                  "date BIGINT,"
+                                  "type BIGINT,"
+                                  "PRIMARY KEY (chatId, userId))");
+        participantsQuery.exec();
+
+        db_version = 6;
+    }
+    if (db_version == 6)
+    {
+        QSqlQuery setsQuery(p->db);
+        setsQuery.prepare("CREATE TABLE IF NOT EXISTS StickerSets ("
+                          "id BIGINT PRIMARY KEY NOT NULL,"
+                          "accessHash BIGINT,"
+                          "title TEXT,"
+                          "shortName TEXT,"
+                          "type BIGINT)");
+        setsQuery.exec();
+
+        QSqlQuery packsQuery(p->db);
+        packsQuery.prepare("CREATE TABLE IF NOT EXISTS StickerPacks ("
+                           "emoticon TEXT PRIMARY KEY NOT NULL,"
+                           "documents TEXT)");
+        packsQuery.exec();
+
+        QSqlQuery documentsQuery(p->db);
+        documentsQuery.prepare("CREATE TABLE IF NOT EXISTS StickerDocuments ("
+                               "id BIGINT PRIMARY KEY NOT NULL,"
+                               "alt TEXT,"
+                               "setId BIGINT,"
+                               "setAccessHash BIGINT,"
+                               "setShortName TEXT,"
+                               "setType BIGINT)");
+        documentsQuery.exec();
+
+        db_version = 7;
+    }
+    if (db_version == 7)
+    {
+        /*! Media pages of a dialog are read by (peer, mediaType) in id
+         *  order; private chats match either toId or fromId. !*/
+        QSqlQuery toQuery(p->db);
+        toQuery.prepare("CREATE INDEX IF NOT EXISTS MessagesToMedia ON Messages (toId, toPeerType, mediaType, id)");
+        toQuery.exec();
+
+        QSqlQuery fromQuery(p->db);
+        fromQuery.prepare("CREATE INDEX IF NOT EXISTS MessagesFromMedia ON Messages (fromId, toPeerType, mediaType, id)");
+        fromQuery.exec();
+
+        db_version = 8;
+    }
 
     setValue("version", QString::number(db_version) );
 }
@@ -918,6 +1515,16 @@ QString DatabaseCore::usersToString(const QList<qint32> &users)
     return list.join(",");
 }
 
+/*! Media class types are stored unsigned !*/
+QString DatabaseCore::mediaTypesToString(const QList<qint32> &mediaTypes)
+{
+    QStringList list;
+    Q_FOREACH(const qint32 t, mediaTypes)
+        list << QString::number(static_cast<quint32>(t));
+
+    return list.join(",");
+}
+
 void DatabaseCore::insertAudio(const Audio &audio)
 {
     if(audio.id() == 0 || audio.classType() == Audio::typeAudioEmpty)
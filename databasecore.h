@@ -5,6 +5,7 @@
 #include "databaseabstractencryptor.h"
 
 #include <QObject>
+#include <QList>
 #include <telegram/types/types.h>
 
 class TELEGRAMQMLSHARED_EXPORT DbChat { public: DbChat(): chat(Chat::typeChatEmpty){} Chat chat; };
@@ -12,6 +13,8 @@ class TELEGRAMQMLSHARED_EXPORT DbUser { public: DbUser(): user(User::typeUserEmp
 class TELEGRAMQMLSHARED_EXPORT DbDialog { public: DbDialog(): dialog(){} Dialog dialog; };
 class TELEGRAMQMLSHARED_EXPORT DbContact { public: DbContact(): contact(){} Contact contact; };
 class TELEGRAMQMLSHARED_EXPORT DbMessage { public: DbMessage(): message(){} Message message; };
+class TELEGRAMQMLSHARED_EXPORT DbChatFull { public: DbChatFull(): chatFull(){} ChatFull chatFull; };
+class TELEGRAMQMLSHARED_EXPORT DbAllStickers { public: DbAllStickers(): stickers(){} MessagesAllStickers stickers; };
 class TELEGRAMQMLSHARED_EXPORT DbPeer { public: DbPeer(): peer(Peer::typePeerUser){} Peer peer; };
 
 class TELEGRAMQMLSHARED_EXPORT DatabaseNormalEncrypter: public DatabaseAbstractEncryptor
@@ -21,6 +24,7 @@ public:
     QString decrypt(const QVariant &data) { return data.toString(); }
 };
 
+class QSqlQuery;
 class DatabaseCorePrivate;
 class TELEGRAMQMLSHARED_EXPORT DatabaseCore : public QObject
 {
@@ -42,11 +46,19 @@ public Q_SLOTS:
     void insertContact(const DbContact &contact);
     void insertMessage(const DbMessage &message, bool encrypted);
     void insertMediaEncryptedKeys(qint64 mediaId, const QByteArray &key, const QByteArray &iv);
+    void insertChatFull(const DbChatFull &chatFull);
+    void insertStickers(const DbAllStickers &stickers);
 
     void updateUnreadCount(qint64 chatId, int unreadCount);
 
     void readFullDialogs();
     void readMessages(const DbPeer &peer, int offset, int limit);
+    void readMessagesFrom(const DbPeer &peer, qint64 fromId, bool newer, int limit);
+    void readMedia(const DbPeer &peer, const QList<qint32> &mediaTypes, qint64 maxId, int limit);
+    void readMediaCounts(const DbPeer &peer, const QList<qint32> &mediaTypes);
+    void searchMessages(const DbPeer &peer, const QString &keyword, qint64 maxId, int limit);
+    void readStickers();
+    void fetchMissing(const QList<qint32> &messages, const QList<qint32> &users, const QList<qint32> &chats);
     void markMessagesAsRead(const QList<qint32>& messages);
     void markMessagesAsReadFromMaxDate(qint32 chatId, qint32 maxDate);
 
@@ -57,6 +69,8 @@ public Q_SLOTS:
     void deleteDialog(qint64 dlgId);
     void deleteHistory(qint64 dlgId);
 
+    void deleteContact(qint64 userId);
+
     void blockUser(qint64 userId);
     void unblockUser(qint64 userId);
 
@@ -66,14 +80,23 @@ Q_SIGNALS:
     void dialogFounded(const DbDialog &dialog, bool encrypted);
     void contactFounded(const DbContact &contact);
     void messageFounded(const DbMessage &message);
+    void chatFullFounded(const DbChatFull &chatFull, qint64 updated);
+    void stickersFounded(const DbAllStickers &stickers);
     void mediaKeyFounded(qint64 mediaId, const QByteArray &key, const QByteArray &iv);
     void valueChanged(const QString &value);
+    void valueFounded(const QString &key, const QString &value);
+    void missingFetched(const QList<qint32> &messages, const QList<qint32> &users, const QList<qint32> &chats);
+    void mediaFounded(const DbPeer &peer, const QList<qint32> &mediaTypes, qint64 maxId, const QList<qint32> &messages);
+    void mediaCountsFounded(const DbPeer &peer, const QList<qint32> &mediaTypes, const QList<qint32> &counts);
+    void messagesSearched(const DbPeer &peer, const QString &keyword, qint64 maxId, const QList<qint32> &messages);
 
 private:
     void readDialogs();
-    void readUsers();
-    void readChats();
+    void readUsers(const QList<qint32> &ids = QList<qint32>());
+    void readChats(const QList<qint32> &ids = QList<qint32>());
+    QList<qint32> readMessages(QSqlQuery &query);
     void readContacts();
+    void readChatFulls();
 
     void init_buffer();
     void update_db();
@@ -85,6 +108,7 @@ private:
 
     QList<qint32> stringToUsers(const QString &str);
     QString usersToString( const QList<qint32> &users );
+    QString mediaTypesToString( const QList<qint32> &mediaTypes );
 
     void insertAudio(const Audio &audio);
     void insertVideo(const Video &video);
@@ -117,5 +141,7 @@ Q_DECLARE_METATYPE(DbDialog)
 Q_DECLARE_METATYPE(DbContact)
 Q_DECLARE_METATYPE(DbMessage)
 Q_DECLARE_METATYPE(DbPeer)
+Q_DECLARE_METATYPE(DbChatFull)
+Q_DECLARE_METATYPE(DbAllStickers)
 
 #endif // DATABASECORE_H
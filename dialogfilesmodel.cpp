@@ -1,14 +1,20 @@
 #include "dialogfilesmodel.h"
 #include "telegramqml.h"
+#include "telegramfileindex.h"
 #include "objects/types.h"
 
 #include <QPointer>
+#include <algorithm>
+#include <QFileInfo>
 
 class DialogFilesModelPrivate
 {
 public:
     QStringList list;
+    QHash<QString,TelegramFileIndexEntry> entries;
+    QString path;
     QPointer<TelegramQml> telegram;
+    QPointer<TelegramFileIndex> index;
     DialogObject *dialog;
 };
 
@@ -30,7 +36,19 @@ void DialogFilesModel::setTelegram(TelegramQml *tg)
     if(p->telegram == tg)
         return;
 
+    setPath(QString());
+    if(p->index)
+        disconnect(p->index, 0, this, 0);
+
     p->telegram = tg;
+    p->index = tg? tg->fileIndex() : 0;
+    if(p->index)
+    {
+        connect(p->index, SIGNAL(directoryIndexed(QString)), SLOT(directoryIndexed(QString)));
+        connect(p->index, SIGNAL(fileChanged(QString,QString)), SLOT(fileChanged(QString,QString)));
+        connect(p->index, SIGNAL(fileRemoved(QString,QString)), SLOT(fileRemoved(QString,QString)));
+    }
+
     Q_EMIT telegramChanged();
 
     refresh();
@@ -79,11 +97,23 @@ QVariant DialogFilesModel::data(const QModelIndex &index, int role) const
 
     case PathRole:
     case ThumbnailRole:
-        res = dirPath() + "/" + fileName;
+        res = p->path + "/" + fileName;
         break;
 
     case SuffixRole:
-        res = "";
+        res = QFileInfo(fileName).suffix();
+        break;
+
+    case SizeRole:
+        res = p->entries.value(fileName).size;
+        break;
+
+    case ModifiedRole:
+        res = p->entries.value(fileName).modified;
+        break;
+
+    case MimeTypeRole:
+        res = p->entries.value(fileName).mimeType;
         break;
     }
 
@@ -101,6 +131,9 @@ QHash<qint32, QByteArray> DialogFilesModel::roleNames() const
     res->insert( PathRole, "path");
     res->insert( ThumbnailRole, "thumbnail");
     res->insert( SuffixRole, "suffix");
+    res->insert( SizeRole, "size");
+    res->insert( ModifiedRole, "modified");
+    res->insert( MimeTypeRole, "mimeType");
     return *res;
 }
 
@@ -111,61 +144,126 @@ int DialogFilesModel::count() const
 
 void DialogFilesModel::refresh()
 {
-    QStringList list;
-    if(p->dialog && p->telegram)
-        list = QDir(dirPath()).entryList(QDir::Files, QDir::Time|QDir::Reversed);
+    setPath(dirPath());
+    if(p->index && p->index->indexed(p->path))
+        directoryIndexed(p->path);
+}
 
-    for( int i=0 ; i<p->list.count() ; i++ )
-    {
-        const QString & dId = p->list.at(i);
-        if( list.contains(dId) )
-            continue;
-
-        beginRemoveRows(QModelIndex(), i, i);
-        p->list.removeAt(i);
-        i--;
-        endRemoveRows();
-    }
+/*! Files are ordered by modification time, oldest first !*/
+bool DialogFilesModel::lessThan(const QString &a, const QString &b) const
+{
+    const QDateTime &ma = p->entries.value(a).modified;
+    const QDateTime &mb = p->entries.value(b).modified;
+    if(ma != mb)
+        return ma < mb;
 
+    return a < b;
+}
 
-    QList<QString> temp_msgs = list;
-    for( int i=0 ; i<temp_msgs.count() ; i++ )
-    {
-        const QString & dId = temp_msgs.at(i);
-        if( p->list.contains(dId) )
-            continue;
+void DialogFilesModel::directoryIndexed(const QString &path)
+{
+    if(path != p->path || !p->index)
+        return;
 
-        temp_msgs.removeAt(i);
-        i--;
-    }
-    while( p->list != temp_msgs )
-        for( int i=0 ; i<p->list.count() ; i++ )
-        {
-            const QString & dId = p->list.at(i);
-            int nw = temp_msgs.indexOf(dId);
-            if( i == nw )
-                continue;
+    p->entries.clear();
+    const QStringList &files = p->index->files(path);
+    Q_FOREACH(const QString &name, files)
+        p->entries[name] = p->index->entry(path, name);
+
+    QStringList list = files;
+    std::stable_sort(list.begin(), list.end(), [this](const QString &a, const QString &b){
+        return lessThan(a, b);
+    });
+
+    syncList(p->list, list);
+
+    Q_EMIT countChanged();
+}
+
+void DialogFilesModel::fileChanged(const QString &path, const QString &name)
+{
+    if(path != p->path || !p->index)
+        return;
 
-            beginMoveRows( QModelIndex(), i, i, QModelIndex(), nw>i?nw+1:nw );
-            p->list.move( i, nw );
-            endMoveRows();
-        }
+    const int oldRow = p->list.indexOf(name);
+    if(oldRow != -1)
+        p->list.removeAt(oldRow);
 
+    p->entries[name] = p->index->entry(path, name);
 
-    for( int i=0 ; i<list.count() ; i++ )
+    int lo = 0;
+    int hi = p->list.count();
+    while(lo < hi)
     {
-        const QString & dId = list.at(i);
-        if( p->list.contains(dId) )
-            continue;
+        const int mid = (lo+hi)/2;
+        if(lessThan(p->list.at(mid), name))
+            lo = mid+1;
+        else
+            hi = mid;
+    }
 
-        beginInsertRows(QModelIndex(), i, i );
-        p->list.insert( i, dId );
+    if(oldRow == -1)
+    {
+        beginInsertRows(QModelIndex(), lo, lo);
+        p->list.insert(lo, name);
         endInsertRows();
+        Q_EMIT countChanged();
+        return;
     }
 
+    if(lo != oldRow)
+    {
+        p->list.insert(oldRow, name);
+        beginMoveRows(QModelIndex(), oldRow, oldRow, QModelIndex(), lo>oldRow? lo+1 : lo);
+        p->list.move(oldRow, lo);
+        endMoveRows();
+    }
+    else
+        p->list.insert(lo, name);
+
+    const QModelIndex &idx = index(lo);
+    Q_EMIT dataChanged(idx, idx, QVector<int>()<<SizeRole<<ModifiedRole<<MimeTypeRole);
+}
+
+void DialogFilesModel::fileRemoved(const QString &path, const QString &name)
+{
+    if(path != p->path)
+        return;
+
+    p->entries.remove(name);
+    const int row = p->list.indexOf(name);
+    if(row == -1)
+        return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    p->list.removeAt(row);
+    endRemoveRows();
+
     Q_EMIT countChanged();
 }
 
+void DialogFilesModel::setPath(const QString &path)
+{
+    if(p->path == path)
+        return;
+
+    if(p->index && !p->path.isEmpty())
+        p->index->unwatch(p->path);
+
+    p->path = path;
+    p->entries.clear();
+    if(!p->list.isEmpty())
+    {
+        beginResetModel();
+        p->list.clear();
+        endResetModel();
+        Q_EMIT countChanged();
+    }
+
+    if(p->index && !p->path.isEmpty())
+        p->index->watch(p->path);
+}
+
 QString DialogFilesModel::dirPath() const
 {
     if(!p->telegram || !p->dialog)
@@ -175,11 +273,11 @@ QString DialogFilesModel::dirPath() const
     if(!dId)
         dId = p->dialog->peer()->userId();
 
-    return p->telegram->downloadPath() + "/" + QString::number(dId);
+    return QFileInfo(p->telegram->downloadPath() + "/" + QString::number(dId)).absoluteFilePath();
 }
 
 DialogFilesModel::~DialogFilesModel()
 {
+    setPath(QString());
     delete p;
 }
-
@@ -21,7 +21,10 @@ public:
         NameRole = Qt::UserRole,
         PathRole,
         ThumbnailRole,
-        SuffixRole
+        SuffixRole,
+        SizeRole,
+        ModifiedRole,
+        MimeTypeRole
     };
 
     DialogFilesModel(QObject *parent = 0);
@@ -50,8 +53,15 @@ Q_SIGNALS:
     void countChanged();
     void dialogChanged();
 
+private Q_SLOTS:
+    void directoryIndexed(const QString &path);
+    void fileChanged(const QString &path, const QString &name);
+    void fileRemoved(const QString &path, const QString &name);
+
 private:
     QString dirPath() const;
+    void setPath(const QString &path);
+    bool lessThan(const QString &a, const QString &b) const;
 
 private:
     DialogFilesModelPrivate *p;
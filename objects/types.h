@@ -1,6 +1,11 @@
 // This file is generated by Aseman Object Creator
 // https://github.com/aseman-land/aseman-object-creator
 // Command: /home/bardia/Projects/build/AsemanQtObjectCreator/Desktop_Qt_5_4_0_GCC_64bit/Debug/AsemanQtObjectCreator if=/home/bardia/Projects/Aseman/Apps/Cutegram/Cutegram/objects/types.sco of=/home/bardia/Projects/Aseman/Apps/Cutegram/Cutegram/objects/types.h template_class=/home/bardia/Projects/Aseman/Apps/Cutegram/Cutegram/objects/templates/class.template template_equals=/home/bardia/Projects/Aseman/Apps/Cutegram/Cutegram/objects/templates/equals.template template_initialize=/home/bardia/Projects/Aseman/Apps/Cutegram/Cutegram/objects/templates/initialize.template template_file=/home/bardia/Projects/Aseman/Apps/Cutegram/Cutegram/objects/templates/file.template
+//
+// NOTE: This file is maintained by hand now. It was generated once, but the
+// update() methods, the lazy child objects and the export macros were added
+// here and can't be produced from objects/templates. Don't regenerate it
+// over these changes; edit the classes directly.
 
 #ifndef TELEGRAMQMLTYPEOBJECT_H
 #define TELEGRAMQMLTYPEOBJECT_H
@@ -396,7 +401,8 @@ public:
     }
 
 
-    void operator= ( const FileLocation & another) {
+    bool update( const FileLocation & another) {
+        bool modified = false;
         if(_localId != another.localId()) {
             _download->setFileId(0);
             _download->setMtime(0);
@@ -404,27 +410,62 @@ public:
             _download->setDownloaded(0);
             _download->setTotal(0);
             Q_EMIT downloadChanged();
+            modified = true;
         }
 
-        _id = 0;
-        Q_EMIT idChanged();
-        _fileName.clear();
-        Q_EMIT fileNameChanged();
-        _mimeType.clear();
-        Q_EMIT mimeTypeChanged();
-        _localId = another.localId();
-        Q_EMIT localIdChanged();
-        _secret = another.secret();
-        Q_EMIT secretChanged();
-        _dcId = another.dcId();
-        Q_EMIT dcIdChanged();
-        _accessHash = 0;
-        Q_EMIT accessHashChanged();
-        _volumeId = another.volumeId();
-        Q_EMIT volumeIdChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+        if(_id != 0) {
+            _id = 0;
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(!_fileName.isEmpty()) {
+            _fileName.clear();
+            Q_EMIT fileNameChanged();
+            modified = true;
+        }
+        if(!_mimeType.isEmpty()) {
+            _mimeType.clear();
+            Q_EMIT mimeTypeChanged();
+            modified = true;
+        }
+        if(_localId != another.localId()) {
+            _localId = another.localId();
+            Q_EMIT localIdChanged();
+            modified = true;
+        }
+        if(_secret != another.secret()) {
+            _secret = another.secret();
+            Q_EMIT secretChanged();
+            modified = true;
+        }
+        if(_dcId != another.dcId()) {
+            _dcId = another.dcId();
+            Q_EMIT dcIdChanged();
+            modified = true;
+        }
+        if(_accessHash != 0) {
+            _accessHash = 0;
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_volumeId != another.volumeId()) {
+            _volumeId = another.volumeId();
+            Q_EMIT volumeIdChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const FileLocation & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -511,14 +552,31 @@ public:
     }
 
 
-    void operator= ( const Peer & another) {
-        _chatId = another.chatId();
-        Q_EMIT chatIdChanged();
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const Peer & another) {
+        bool modified = false;
+        if(_chatId != another.chatId()) {
+            _chatId = another.chatId();
+            Q_EMIT chatIdChanged();
+            modified = true;
+        }
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const Peer & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -591,14 +649,31 @@ public:
     }
 
 
-    void operator= ( const Contact & another) {
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        _mutual = another.mutual();
-        Q_EMIT mutualChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const Contact & another) {
+        bool modified = false;
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_mutual != another.mutual()) {
+            _mutual = another.mutual();
+            Q_EMIT mutualChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const Contact & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -685,16 +760,36 @@ public:
     }
 
 
-    void operator= ( const InputPeer & another) {
-        _chatId = another.chatId();
-        Q_EMIT chatIdChanged();
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const InputPeer & another) {
+        bool modified = false;
+        if(_chatId != another.chatId()) {
+            _chatId = another.chatId();
+            Q_EMIT chatIdChanged();
+            modified = true;
+        }
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const InputPeer & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -769,14 +864,31 @@ public:
     }
 
 
-    void operator= ( const UserStatus & another) {
-        _wasOnline = another.wasOnline();
-        Q_EMIT wasOnlineChanged();
-        _expires = another.expires();
-        Q_EMIT expiresChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const UserStatus & another) {
+        bool modified = false;
+        if(_wasOnline != another.wasOnline()) {
+            _wasOnline = another.wasOnline();
+            Q_EMIT wasOnlineChanged();
+            modified = true;
+        }
+        if(_expires != another.expires()) {
+            _expires = another.expires();
+            Q_EMIT expiresChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const UserStatus & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -849,14 +961,31 @@ public:
     }
 
 
-    void operator= ( const GeoPoint & another) {
-        _longitude = another.longValue();
-        Q_EMIT longitudeChanged();
-        _lat = another.lat();
-        Q_EMIT latChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const GeoPoint & another) {
+        bool modified = false;
+        if(_longitude != another.longValue()) {
+            _longitude = another.longValue();
+            Q_EMIT longitudeChanged();
+            modified = true;
+        }
+        if(_lat != another.lat()) {
+            _lat = another.lat();
+            Q_EMIT latChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const GeoPoint & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -957,18 +1086,41 @@ public:
     }
 
 
-    void operator= ( const PeerNotifySettings & another) {
-        _muteUntil = another.muteUntil();
-        Q_EMIT muteUntilChanged();
-        _eventsMask = another.eventsMask();
-        Q_EMIT eventsMaskChanged();
-        _sound = another.sound();
-        Q_EMIT soundChanged();
-        _showPreviews = another.showPreviews();
-        Q_EMIT showPreviewsChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const PeerNotifySettings & another) {
+        bool modified = false;
+        if(_muteUntil != another.muteUntil()) {
+            _muteUntil = another.muteUntil();
+            Q_EMIT muteUntilChanged();
+            modified = true;
+        }
+        if(_eventsMask != another.eventsMask()) {
+            _eventsMask = another.eventsMask();
+            Q_EMIT eventsMaskChanged();
+            modified = true;
+        }
+        if(_sound != another.sound()) {
+            _sound = another.sound();
+            Q_EMIT soundChanged();
+            modified = true;
+        }
+        if(_showPreviews != another.showPreviews()) {
+            _showPreviews = another.showPreviews();
+            Q_EMIT showPreviewsChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const PeerNotifySettings & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -1087,20 +1239,46 @@ public:
     }
 
 
-    void operator= ( const EncryptedFile & another) {
-        _dcId = another.dcId();
-        Q_EMIT dcIdChanged();
-        _id = another.id();
-        Q_EMIT idChanged();
-        _keyFingerprint = another.keyFingerprint();
-        Q_EMIT keyFingerprintChanged();
-        _size = another.size();
-        Q_EMIT sizeChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const EncryptedFile & another) {
+        bool modified = false;
+        if(_dcId != another.dcId()) {
+            _dcId = another.dcId();
+            Q_EMIT dcIdChanged();
+            modified = true;
+        }
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_keyFingerprint != another.keyFingerprint()) {
+            _keyFingerprint = another.keyFingerprint();
+            Q_EMIT keyFingerprintChanged();
+            modified = true;
+        }
+        if(_size != another.size()) {
+            _size = another.size();
+            Q_EMIT sizeChanged();
+            modified = true;
+        }
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const EncryptedFile & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -1263,26 +1441,61 @@ public:
     }
 
 
-    void operator= ( const EncryptedChat & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _gA = another.gA();
-        Q_EMIT gAChanged();
-        _keyFingerprint = another.keyFingerprint();
-        Q_EMIT keyFingerprintChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _adminId = another.adminId();
-        Q_EMIT adminIdChanged();
-        _gAOrB = another.gAOrB();
-        Q_EMIT gAOrBChanged();
-        _participantId = another.participantId();
-        Q_EMIT participantIdChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const EncryptedChat & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_gA != another.gA()) {
+            _gA = another.gA();
+            Q_EMIT gAChanged();
+            modified = true;
+        }
+        if(_keyFingerprint != another.keyFingerprint()) {
+            _keyFingerprint = another.keyFingerprint();
+            Q_EMIT keyFingerprintChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_adminId != another.adminId()) {
+            _adminId = another.adminId();
+            Q_EMIT adminIdChanged();
+            modified = true;
+        }
+        if(_gAOrB != another.gAOrB()) {
+            _gAOrB = another.gAOrB();
+            Q_EMIT gAOrBChanged();
+            modified = true;
+        }
+        if(_participantId != another.participantId()) {
+            _participantId = another.participantId();
+            Q_EMIT participantIdChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const EncryptedChat & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -1411,20 +1624,43 @@ public:
     }
 
 
-    void operator= ( const EncryptedMessage & another) {
-        _chatId = another.chatId();
-        Q_EMIT chatIdChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        _randomId = another.randomId();
-        Q_EMIT randomIdChanged();
-        *_file = another.file();
-        Q_EMIT fileChanged();
-        _bytes = another.bytes();
-        Q_EMIT bytesChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const EncryptedMessage & another) {
+        bool modified = false;
+        if(_chatId != another.chatId()) {
+            _chatId = another.chatId();
+            Q_EMIT chatIdChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(_randomId != another.randomId()) {
+            _randomId = another.randomId();
+            Q_EMIT randomIdChanged();
+            modified = true;
+        }
+        if(_file->update(another.file()))
+            modified = true;
+        if(_bytes != another.bytes()) {
+            _bytes = another.bytes();
+            Q_EMIT bytesChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const EncryptedMessage & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -1475,10 +1711,21 @@ public:
     }
 
 
-    void operator= ( const ContactLink & another) {
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const ContactLink & another) {
+        bool modified = false;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const ContactLink & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -1535,12 +1782,23 @@ public:
     }
 
 
-    void operator= ( const NotifyPeer & another) {
-        *_peer = another.peer();
-        Q_EMIT peerChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const NotifyPeer & another) {
+        bool modified = false;
+        if(_peer->update(another.peer()))
+            modified = true;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const NotifyPeer & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -1625,16 +1883,36 @@ public:
     }
 
 
-    void operator= ( const ChatParticipant & another) {
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        _inviterId = another.inviterId();
-        Q_EMIT inviterIdChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const ChatParticipant & another) {
+        bool modified = false;
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(_inviterId != another.inviterId()) {
+            _inviterId = another.inviterId();
+            Q_EMIT inviterIdChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const ChatParticipant & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -1739,18 +2017,39 @@ public:
     }
 
 
-    void operator= ( const ChatParticipants & another) {
+    bool update( const ChatParticipants & another) {
+        bool modified = false;
         *_participants = another.participants();
         Q_EMIT participantsChanged();
-        _chatId = another.chatId();
-        Q_EMIT chatIdChanged();
-        _version = another.version();
-        Q_EMIT versionChanged();
-        _adminId = another.adminId();
-        Q_EMIT adminIdChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+        modified = true;
+        if(_chatId != another.chatId()) {
+            _chatId = another.chatId();
+            Q_EMIT chatIdChanged();
+            modified = true;
+        }
+        if(_version != another.version()) {
+            _version = another.version();
+            Q_EMIT versionChanged();
+            modified = true;
+        }
+        if(_adminId != another.adminId()) {
+            _adminId = another.adminId();
+            Q_EMIT adminIdChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const ChatParticipants & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -1885,22 +2184,48 @@ public:
     }
 
 
+    bool update( const PhotoSize & another) {
+        bool modified = false;
+        if(_h != another.h()) {
+            _h = another.h();
+            Q_EMIT hChanged();
+            modified = true;
+        }
+        if(_type != another.type()) {
+            _type = another.type();
+            Q_EMIT typeChanged();
+            modified = true;
+        }
+        if(_bytes != another.bytes()) {
+            _bytes = another.bytes();
+            Q_EMIT bytesChanged();
+            modified = true;
+        }
+        if(_location->update(another.location()))
+            modified = true;
+        if(_size != another.size()) {
+            _size = another.size();
+            Q_EMIT sizeChanged();
+            modified = true;
+        }
+        if(_w != another.w()) {
+            _w = another.w();
+            Q_EMIT wChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
     void operator= ( const PhotoSize & another) {
-        _h = another.h();
-        Q_EMIT hChanged();
-        _type = another.type();
-        Q_EMIT typeChanged();
-        _bytes = another.bytes();
-        Q_EMIT bytesChanged();
-        *_location = another.location();
-        Q_EMIT locationChanged();
-        _size = another.size();
-        Q_EMIT sizeChanged();
-        _w = another.w();
-        Q_EMIT wChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
-
+        update(another);
     }
 
 Q_SIGNALS:
@@ -2065,26 +2390,61 @@ public:
     }
 
 
-    void operator= ( const Audio & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _dcId = another.dcId();
-        Q_EMIT dcIdChanged();
-        _mimeType = another.mimeType();
-        Q_EMIT mimeTypeChanged();
-        _duration = another.duration();
-        Q_EMIT durationChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        _size = another.size();
-        Q_EMIT sizeChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const Audio & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_dcId != another.dcId()) {
+            _dcId = another.dcId();
+            Q_EMIT dcIdChanged();
+            modified = true;
+        }
+        if(_mimeType != another.mimeType()) {
+            _mimeType = another.mimeType();
+            Q_EMIT mimeTypeChanged();
+            modified = true;
+        }
+        if(_duration != another.duration()) {
+            _duration = another.duration();
+            Q_EMIT durationChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(_size != another.size()) {
+            _size = another.size();
+            Q_EMIT sizeChanged();
+            modified = true;
+        }
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const Audio & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -2211,20 +2571,46 @@ public:
     }
 
 
-    void operator= ( const DocumentAttribute & another) {
-        _alt = another.alt();
-        Q_EMIT altChanged();
-        _duration = another.duration();
-        Q_EMIT durationChanged();
-        _fileName = another.fileName();
-        Q_EMIT fileNameChanged();
-        _h = another.h();
-        Q_EMIT hChanged();
-        _w = another.w();
-        Q_EMIT wChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const DocumentAttribute & another) {
+        bool modified = false;
+        if(_alt != another.alt()) {
+            _alt = another.alt();
+            Q_EMIT altChanged();
+            modified = true;
+        }
+        if(_duration != another.duration()) {
+            _duration = another.duration();
+            Q_EMIT durationChanged();
+            modified = true;
+        }
+        if(_fileName != another.fileName()) {
+            _fileName = another.fileName();
+            Q_EMIT fileNameChanged();
+            modified = true;
+        }
+        if(_h != another.h()) {
+            _h = another.h();
+            Q_EMIT hChanged();
+            modified = true;
+        }
+        if(_w != another.w()) {
+            _w = another.w();
+            Q_EMIT wChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const DocumentAttribute & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -2387,25 +2773,56 @@ public:
     }
 
 
-    void operator= ( const Document & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _dcId = another.dcId();
-        Q_EMIT dcIdChanged();
-        _mimeType = another.mimeType();
-        Q_EMIT mimeTypeChanged();
-        *_thumb = another.thumb();
-        Q_EMIT thumbChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
+    bool update( const Document & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_dcId != another.dcId()) {
+            _dcId = another.dcId();
+            Q_EMIT dcIdChanged();
+            modified = true;
+        }
+        if(_mimeType != another.mimeType()) {
+            _mimeType = another.mimeType();
+            Q_EMIT mimeTypeChanged();
+            modified = true;
+        }
+        if(_thumb->update(another.thumb()))
+            modified = true;
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
         _attributes = another.attributes();
         Q_EMIT attributesChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _size = another.size();
-        Q_EMIT sizeChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+        modified = true;
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_size != another.size()) {
+            _size = another.size();
+            Q_EMIT sizeChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const Document & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -2604,30 +3021,68 @@ public:
     }
 
 
-    void operator= ( const Video & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _dcId = another.dcId();
-        Q_EMIT dcIdChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        *_thumb = another.thumb();
-        Q_EMIT thumbChanged();
-        _duration = another.duration();
-        Q_EMIT durationChanged();
-        _h = another.h();
-        Q_EMIT hChanged();
-        _size = another.size();
-        Q_EMIT sizeChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        _w = another.w();
-        Q_EMIT wChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const Video & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_dcId != another.dcId()) {
+            _dcId = another.dcId();
+            Q_EMIT dcIdChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(_thumb->update(another.thumb()))
+            modified = true;
+        if(_duration != another.duration()) {
+            _duration = another.duration();
+            Q_EMIT durationChanged();
+            modified = true;
+        }
+        if(_h != another.h()) {
+            _h = another.h();
+            Q_EMIT hChanged();
+            modified = true;
+        }
+        if(_size != another.size()) {
+            _size = another.size();
+            Q_EMIT sizeChanged();
+            modified = true;
+        }
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_w != another.w()) {
+            _w = another.w();
+            Q_EMIT wChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const Video & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -2774,22 +3229,46 @@ public:
     }
 
 
-    void operator= ( const Photo & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
+    bool update( const Photo & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
         *_sizes = another.sizes();
         Q_EMIT sizesChanged();
-        *_geo = another.geo();
-        Q_EMIT geoChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+        modified = true;
+        if(_geo->update(another.geo()))
+            modified = true;
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const Photo & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -3039,37 +3518,88 @@ public:
         Q_EMIT changed();
     }
 
-    void operator= ( const WebPage & another ) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _author = another.author();
-        Q_EMIT authorChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        _description = another.description();
-        Q_EMIT descriptionChanged();
-        _displayUrl = another.displayUrl();
-        Q_EMIT displayUrlChanged();
-        _duration = another.duration();
-        Q_EMIT durationChanged();
-        _embedHeight = another.embedHeight();
-        Q_EMIT embedHeightChanged();
-        _embedType = another.embedType();
-        Q_EMIT embedTypeChanged();
-        _embedUrl = another.embedUrl();
-        Q_EMIT embedUrlChanged();
-        _embedWidth = another.embedWidth();
-        Q_EMIT embedWidthChanged();
-        *_photo = another.photo();
-        Q_EMIT photoChanged();
-        _siteName = another.siteName();
-        Q_EMIT siteNameChanged();
-        _title = another.title();
-        Q_EMIT titleChanged();
-        _url = another.url();
-        Q_EMIT urlChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const WebPage & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_author != another.author()) {
+            _author = another.author();
+            Q_EMIT authorChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(_description != another.description()) {
+            _description = another.description();
+            Q_EMIT descriptionChanged();
+            modified = true;
+        }
+        if(_displayUrl != another.displayUrl()) {
+            _displayUrl = another.displayUrl();
+            Q_EMIT displayUrlChanged();
+            modified = true;
+        }
+        if(_duration != another.duration()) {
+            _duration = another.duration();
+            Q_EMIT durationChanged();
+            modified = true;
+        }
+        if(_embedHeight != another.embedHeight()) {
+            _embedHeight = another.embedHeight();
+            Q_EMIT embedHeightChanged();
+            modified = true;
+        }
+        if(_embedType != another.embedType()) {
+            _embedType = another.embedType();
+            Q_EMIT embedTypeChanged();
+            modified = true;
+        }
+        if(_embedUrl != another.embedUrl()) {
+            _embedUrl = another.embedUrl();
+            Q_EMIT embedUrlChanged();
+            modified = true;
+        }
+        if(_embedWidth != another.embedWidth()) {
+            _embedWidth = another.embedWidth();
+            Q_EMIT embedWidthChanged();
+            modified = true;
+        }
+        if(_photo->update(another.photo()))
+            modified = true;
+        if(_siteName != another.siteName()) {
+            _siteName = another.siteName();
+            Q_EMIT siteNameChanged();
+            modified = true;
+        }
+        if(_title != another.title()) {
+            _title = another.title();
+            Q_EMIT titleChanged();
+            modified = true;
+        }
+        if(_url != another.url()) {
+            _url = another.url();
+            Q_EMIT urlChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const WebPage & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -3208,20 +3738,44 @@ public:
     }
 
 
-    void operator= ( const WallPaper & another) {
-        _bgColor = another.bgColor();
-        Q_EMIT bgColorChanged();
-        _color = another.color();
-        Q_EMIT colorChanged();
-        _id = another.id();
-        Q_EMIT idChanged();
-        _title = another.title();
-        Q_EMIT titleChanged();
+    bool update( const WallPaper & another) {
+        bool modified = false;
+        if(_bgColor != another.bgColor()) {
+            _bgColor = another.bgColor();
+            Q_EMIT bgColorChanged();
+            modified = true;
+        }
+        if(_color != another.color()) {
+            _color = another.color();
+            Q_EMIT colorChanged();
+            modified = true;
+        }
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_title != another.title()) {
+            _title = another.title();
+            Q_EMIT titleChanged();
+            modified = true;
+        }
         *_sizes = another.sizes();
         Q_EMIT sizesChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+        modified = true;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const WallPaper & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -3358,20 +3912,43 @@ public:
     }
 
 
-    void operator= ( const MessageAction & another) {
-        _address = another.address();
-        Q_EMIT addressChanged();
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        *_photo = another.photo();
-        Q_EMIT photoChanged();
-        _title = another.title();
-        Q_EMIT titleChanged();
-        _users = another.users();
-        Q_EMIT usersChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const MessageAction & another) {
+        bool modified = false;
+        if(_address != another.address()) {
+            _address = another.address();
+            Q_EMIT addressChanged();
+            modified = true;
+        }
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_photo->update(another.photo()))
+            modified = true;
+        if(_title != another.title()) {
+            _title = another.title();
+            Q_EMIT titleChanged();
+            modified = true;
+        }
+        if(_users != another.users()) {
+            _users = another.users();
+            Q_EMIT usersChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const MessageAction & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -3455,14 +4032,25 @@ public:
     }
 
 
-    void operator= ( const ChatPhoto & another) {
-        *_photoBig = another.photoBig();
-        Q_EMIT photoBigChanged();
-        *_photoSmall = another.photoSmall();
-        Q_EMIT photoSmallChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const ChatPhoto & another) {
+        bool modified = false;
+        if(_photoBig->update(another.photoBig()))
+            modified = true;
+        if(_photoSmall->update(another.photoSmall()))
+            modified = true;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const ChatPhoto & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -3567,18 +4155,32 @@ public:
     }
 
 
-    void operator= ( const ChatFull & another) {
-        *_participants = another.participants();
-        Q_EMIT participantsChanged();
-        *_chatPhoto = another.chatPhoto();
-        Q_EMIT chatPhotoChanged();
-        _id = another.id();
-        Q_EMIT idChanged();
-        *_notifySettings = another.notifySettings();
-        Q_EMIT notifySettingsChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const ChatFull & another) {
+        bool modified = false;
+        if(_participants->update(another.participants()))
+            modified = true;
+        if(_chatPhoto->update(another.chatPhoto()))
+            modified = true;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_notifySettings->update(another.notifySettings()))
+            modified = true;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const ChatFull & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -3672,16 +4274,30 @@ public:
     }
 
 
-    void operator= ( const UserProfilePhoto & another) {
-        _photoId = another.photoId();
-        Q_EMIT photoIdChanged();
-        *_photoBig = another.photoBig();
-        Q_EMIT photoBigChanged();
-        *_photoSmall = another.photoSmall();
-        Q_EMIT photoSmallChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const UserProfilePhoto & another) {
+        bool modified = false;
+        if(_photoId != another.photoId()) {
+            _photoId = another.photoId();
+            Q_EMIT photoIdChanged();
+            modified = true;
+        }
+        if(_photoBig->update(another.photoBig()))
+            modified = true;
+        if(_photoSmall->update(another.photoSmall()))
+            modified = true;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const UserProfilePhoto & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -3899,34 +4515,75 @@ public:
     }
 
 
-    void operator= ( const Chat & another) {
-        _participantsCount = another.participantsCount();
-        Q_EMIT participantsCountChanged();
-        _id = another.id();
-        Q_EMIT idChanged();
-        _version = another.version();
-        Q_EMIT versionChanged();
-        _venue = another.venue();
-        Q_EMIT venueChanged();
-        _title = another.title();
-        Q_EMIT titleChanged();
-        _address = another.address();
-        Q_EMIT addressChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        *_photo = another.photo();
-        Q_EMIT photoChanged();
-        *_geo = another.geo();
-        Q_EMIT geoChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _checkedIn = another.checkedIn();
-        Q_EMIT checkedInChanged();
-        _left = another.left();
-        Q_EMIT leftChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const Chat & another) {
+        bool modified = false;
+        if(_participantsCount != another.participantsCount()) {
+            _participantsCount = another.participantsCount();
+            Q_EMIT participantsCountChanged();
+            modified = true;
+        }
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_version != another.version()) {
+            _version = another.version();
+            Q_EMIT versionChanged();
+            modified = true;
+        }
+        if(_venue != another.venue()) {
+            _venue = another.venue();
+            Q_EMIT venueChanged();
+            modified = true;
+        }
+        if(_title != another.title()) {
+            _title = another.title();
+            Q_EMIT titleChanged();
+            modified = true;
+        }
+        if(_address != another.address()) {
+            _address = another.address();
+            Q_EMIT addressChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(_photo->update(another.photo()))
+            modified = true;
+        if(_geo->update(another.geo()))
+            modified = true;
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_checkedIn != another.checkedIn()) {
+            _checkedIn = another.checkedIn();
+            Q_EMIT checkedInChanged();
+            modified = true;
+        }
+        if(_left != another.left()) {
+            _left = another.left();
+            Q_EMIT leftChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const Chat & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -4077,20 +4734,40 @@ public:
     }
 
 
-    void operator= ( const Dialog & another) {
-        *_peer = another.peer();
-        Q_EMIT peerChanged();
-        *_notifySettings = another.notifySettings();
-        Q_EMIT notifySettingsChanged();
-        _topMessage = another.topMessage();
-        Q_EMIT topMessageChanged();
-        _unreadCount = another.unreadCount();
-        Q_EMIT unreadCountChanged();
-        _typingUsers.clear();
-        Q_EMIT typingUsersChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const Dialog & another) {
+        bool modified = false;
+        if(_peer->update(another.peer()))
+            modified = true;
+        if(_notifySettings->update(another.notifySettings()))
+            modified = true;
+        if(_topMessage != another.topMessage()) {
+            _topMessage = another.topMessage();
+            Q_EMIT topMessageChanged();
+            modified = true;
+        }
+        if(_unreadCount != another.unreadCount()) {
+            _unreadCount = another.unreadCount();
+            Q_EMIT unreadCountChanged();
+            modified = true;
+        }
+        if(!_typingUsers.isEmpty()) {
+            _typingUsers.clear();
+            Q_EMIT typingUsersChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const Dialog & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -4143,10 +4820,21 @@ public:
     }
 
 
-    void operator= ( const SendMessageAction & another) {
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const SendMessageAction & another) {
+        bool modified = false;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const SendMessageAction & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -4273,22 +4961,48 @@ public:
     }
 
 
-    void operator= ( const DecryptedMessageAction & another) {
-        _layer = another.layer();
-        Q_EMIT layerChanged();
-        _randomIds = another.randomIds();
-        Q_EMIT randomIdsChanged();
-        _ttlSeconds = another.ttlSeconds();
-        Q_EMIT ttlSecondsChanged();
-        _startSeqNo = another.startSeqNo();
-        Q_EMIT startSeqNoChanged();
-        _endSeqNo = another.endSeqNo();
-        Q_EMIT endSeqNoChanged();
-        *_action = another.action();
-        Q_EMIT actionChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const DecryptedMessageAction & another) {
+        bool modified = false;
+        if(_layer != another.layer()) {
+            _layer = another.layer();
+            Q_EMIT layerChanged();
+            modified = true;
+        }
+        if(_randomIds != another.randomIds()) {
+            _randomIds = another.randomIds();
+            Q_EMIT randomIdsChanged();
+            modified = true;
+        }
+        if(_ttlSeconds != another.ttlSeconds()) {
+            _ttlSeconds = another.ttlSeconds();
+            Q_EMIT ttlSecondsChanged();
+            modified = true;
+        }
+        if(_startSeqNo != another.startSeqNo()) {
+            _startSeqNo = another.startSeqNo();
+            Q_EMIT startSeqNoChanged();
+            modified = true;
+        }
+        if(_endSeqNo != another.endSeqNo()) {
+            _endSeqNo = another.endSeqNo();
+            Q_EMIT endSeqNoChanged();
+            modified = true;
+        }
+        if(_action->update(another.action()))
+            modified = true;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const DecryptedMessageAction & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -4579,44 +5293,106 @@ public:
     }
 
 
-    void operator= ( const DecryptedMessageMedia & another) {
-        _thumb = another.thumb();
-        Q_EMIT thumbChanged();
-        _thumbW = another.thumbW();
-        Q_EMIT thumbWChanged();
-        _thumbH = another.thumbH();
-        Q_EMIT thumbHChanged();
-        _duration = another.duration();
-        Q_EMIT durationChanged();
-        _w = another.w();
-        Q_EMIT wChanged();
-        _h = another.h();
-        Q_EMIT hChanged();
-        _size = another.size();
-        Q_EMIT sizeChanged();
-        _latitude = another.latitude();
-        Q_EMIT latitudeChanged();
-        _longitude = another.longitude();
-        Q_EMIT longitudeChanged();
-        _key = another.key();
-        Q_EMIT keyChanged();
-        _iv = another.iv();
-        Q_EMIT ivChanged();
-        _phoneNumber = another.phoneNumber();
-        Q_EMIT phoneNumberChanged();
-        _firstName = another.firstName();
-        Q_EMIT firstNameChanged();
-        _lastName = another.lastName();
-        Q_EMIT lastNameChanged();
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        _fileName = another.fileName();
-        Q_EMIT fileNameChanged();
-        _mimeType = another.mimeType();
-        Q_EMIT mimeTypeChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const DecryptedMessageMedia & another) {
+        bool modified = false;
+        if(_thumb != another.thumb()) {
+            _thumb = another.thumb();
+            Q_EMIT thumbChanged();
+            modified = true;
+        }
+        if(_thumbW != another.thumbW()) {
+            _thumbW = another.thumbW();
+            Q_EMIT thumbWChanged();
+            modified = true;
+        }
+        if(_thumbH != another.thumbH()) {
+            _thumbH = another.thumbH();
+            Q_EMIT thumbHChanged();
+            modified = true;
+        }
+        if(_duration != another.duration()) {
+            _duration = another.duration();
+            Q_EMIT durationChanged();
+            modified = true;
+        }
+        if(_w != another.w()) {
+            _w = another.w();
+            Q_EMIT wChanged();
+            modified = true;
+        }
+        if(_h != another.h()) {
+            _h = another.h();
+            Q_EMIT hChanged();
+            modified = true;
+        }
+        if(_size != another.size()) {
+            _size = another.size();
+            Q_EMIT sizeChanged();
+            modified = true;
+        }
+        if(_latitude != another.latitude()) {
+            _latitude = another.latitude();
+            Q_EMIT latitudeChanged();
+            modified = true;
+        }
+        if(_longitude != another.longitude()) {
+            _longitude = another.longitude();
+            Q_EMIT longitudeChanged();
+            modified = true;
+        }
+        if(_key != another.key()) {
+            _key = another.key();
+            Q_EMIT keyChanged();
+            modified = true;
+        }
+        if(_iv != another.iv()) {
+            _iv = another.iv();
+            Q_EMIT ivChanged();
+            modified = true;
+        }
+        if(_phoneNumber != another.phoneNumber()) {
+            _phoneNumber = another.phoneNumber();
+            Q_EMIT phoneNumberChanged();
+            modified = true;
+        }
+        if(_firstName != another.firstName()) {
+            _firstName = another.firstName();
+            Q_EMIT firstNameChanged();
+            modified = true;
+        }
+        if(_lastName != another.lastName()) {
+            _lastName = another.lastName();
+            Q_EMIT lastNameChanged();
+            modified = true;
+        }
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(_fileName != another.fileName()) {
+            _fileName = another.fileName();
+            Q_EMIT fileNameChanged();
+            modified = true;
+        }
+        if(_mimeType != another.mimeType()) {
+            _mimeType = another.mimeType();
+            Q_EMIT mimeTypeChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const DecryptedMessageMedia & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -4778,22 +5554,45 @@ public:
     }
 
 
-    void operator= ( const DecryptedMessage & another) {
-        _randomId = another.randomId();
-        Q_EMIT randomIdChanged();
-        _ttl = another.ttl();
-        Q_EMIT ttlChanged();
-        _randomBytes = another.randomBytes();
-        Q_EMIT randomBytesChanged();
-        _message = another.message();
-        Q_EMIT messageChanged();
-        *_media = another.media();
-        Q_EMIT mediaChanged();
-        *_action = another.action();
-        Q_EMIT actionChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const DecryptedMessage & another) {
+        bool modified = false;
+        if(_randomId != another.randomId()) {
+            _randomId = another.randomId();
+            Q_EMIT randomIdChanged();
+            modified = true;
+        }
+        if(_ttl != another.ttl()) {
+            _ttl = another.ttl();
+            Q_EMIT ttlChanged();
+            modified = true;
+        }
+        if(_randomBytes != another.randomBytes()) {
+            _randomBytes = another.randomBytes();
+            Q_EMIT randomBytesChanged();
+            modified = true;
+        }
+        if(_message != another.message()) {
+            _message = another.message();
+            Q_EMIT messageChanged();
+            modified = true;
+        }
+        if(_media->update(another.media()))
+            modified = true;
+        if(_action->update(another.action()))
+            modified = true;
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const DecryptedMessage & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -4840,19 +5639,25 @@ class TELEGRAMQMLSHARED_EXPORT MessageMediaObject : public TqObject
     Q_PROPERTY(quint32 classType READ classType WRITE setClassType NOTIFY classTypeChanged)
 
 public:
-    MessageMediaObject(const MessageMedia & another, QObject *parent = 0) : TqObject(parent){
-        (void)another;
-        _audio = new AudioObject(another.audio(), this);
+    MessageMediaObject(const MessageMedia & another, QObject *parent = 0) :
+        TqObject(parent),
+        _audio(0),
+        _document(0),
+        _geo(0),
+        _photo(0),
+        _video(0),
+        _webpage(0),
+        _audioValue(another.audio()),
+        _documentValue(another.document()),
+        _geoValue(another.geo()),
+        _photoValue(another.photo()),
+        _videoValue(another.video()),
+        _webpageValue(another.webpage()){
         _lastName = another.lastName();
         _firstName = another.firstName();
         _caption = another.caption();
-        _document = new DocumentObject(another.document(), this);
-        _geo = new GeoPointObject(another.geo(), this);
-        _photo = new PhotoObject(another.photo(), this);
         _phoneNumber = another.phoneNumber();
         _userId = another.userId();
-        _video = new VideoObject(another.video(), this);
-        _webpage = new WebPageObject(another.webpage(), this);
         _venueTitle = another.title();
         _venueAddress = another.address();
         _encryptKey = QByteArray();
@@ -4871,6 +5676,11 @@ public:
     ~MessageMediaObject(){}
 
     AudioObject* audio() const {
+        if(!_audio)
+        {
+            _audio = new AudioObject(_audioValue, const_cast<MessageMediaObject*>(this));
+            _audioValue = Audio();
+        }
         return _audio;
     }
 
@@ -4919,6 +5729,11 @@ public:
     }
 
     DocumentObject* document() const {
+        if(!_document)
+        {
+            _document = new DocumentObject(_documentValue, const_cast<MessageMediaObject*>(this));
+            _documentValue = Document();
+        }
         return _document;
     }
 
@@ -4931,6 +5746,11 @@ public:
     }
 
     GeoPointObject* geo() const {
+        if(!_geo)
+        {
+            _geo = new GeoPointObject(_geoValue, const_cast<MessageMediaObject*>(this));
+            _geoValue = GeoPoint();
+        }
         return _geo;
     }
 
@@ -4943,6 +5763,11 @@ public:
     }
 
     PhotoObject* photo() const {
+        if(!_photo)
+        {
+            _photo = new PhotoObject(_photoValue, const_cast<MessageMediaObject*>(this));
+            _photoValue = Photo();
+        }
         return _photo;
     }
 
@@ -4979,6 +5804,11 @@ public:
     }
 
     VideoObject* video() const {
+        if(!_video)
+        {
+            _video = new VideoObject(_videoValue, const_cast<MessageMediaObject*>(this));
+            _videoValue = Video();
+        }
         return _video;
     }
 
@@ -4991,6 +5821,11 @@ public:
     }
 
     WebPageObject* webpage() const {
+        if(!_webpage)
+        {
+            _webpage = new WebPageObject(_webpageValue, const_cast<MessageMediaObject*>(this));
+            _webpageValue = WebPage();
+        }
         return _webpage;
     }
 
@@ -5065,36 +5900,86 @@ public:
     }
 
 
-    void operator= ( const MessageMedia & another) {
-        *_audio = another.audio();
-        Q_EMIT audioChanged();
-        _lastName = another.lastName();
-        Q_EMIT lastNameChanged();
-        _firstName = another.firstName();
-        Q_EMIT firstNameChanged();
-        _caption = another.caption();
-        Q_EMIT captionChanged();
-        *_document = another.document();
-        Q_EMIT documentChanged();
-        *_geo = another.geo();
-        Q_EMIT geoChanged();
-        *_photo = another.photo();
-        Q_EMIT photoChanged();
-        _phoneNumber = another.phoneNumber();
-        Q_EMIT phoneNumberChanged();
-        _userId = another.userId();
-        Q_EMIT userIdChanged();
-        *_video = another.video();
-        Q_EMIT videoChanged();
-        *_webpage = another.webpage();
-        Q_EMIT webpageChanged();
-        _venueTitle = another.title();
-        Q_EMIT venueTitleChanged();
-        _venueAddress = another.address();
-        Q_EMIT venueAddressChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const MessageMedia & another) {
+        bool modified = false;
+        if(!_audio)
+            _audioValue = another.audio();
+        else
+        if(_audio->update(another.audio()))
+            modified = true;
+        if(_lastName != another.lastName()) {
+            _lastName = another.lastName();
+            Q_EMIT lastNameChanged();
+            modified = true;
+        }
+        if(_firstName != another.firstName()) {
+            _firstName = another.firstName();
+            Q_EMIT firstNameChanged();
+            modified = true;
+        }
+        if(_caption != another.caption()) {
+            _caption = another.caption();
+            Q_EMIT captionChanged();
+            modified = true;
+        }
+        if(!_document)
+            _documentValue = another.document();
+        else
+        if(_document->update(another.document()))
+            modified = true;
+        if(!_geo)
+            _geoValue = another.geo();
+        else
+        if(_geo->update(another.geo()))
+            modified = true;
+        if(!_photo)
+            _photoValue = another.photo();
+        else
+        if(_photo->update(another.photo()))
+            modified = true;
+        if(_phoneNumber != another.phoneNumber()) {
+            _phoneNumber = another.phoneNumber();
+            Q_EMIT phoneNumberChanged();
+            modified = true;
+        }
+        if(_userId != another.userId()) {
+            _userId = another.userId();
+            Q_EMIT userIdChanged();
+            modified = true;
+        }
+        if(!_video)
+            _videoValue = another.video();
+        else
+        if(_video->update(another.video()))
+            modified = true;
+        if(!_webpage)
+            _webpageValue = another.webpage();
+        else
+        if(_webpage->update(another.webpage()))
+            modified = true;
+        if(_venueTitle != another.title()) {
+            _venueTitle = another.title();
+            Q_EMIT venueTitleChanged();
+            modified = true;
+        }
+        if(_venueAddress != another.address()) {
+            _venueAddress = another.address();
+            Q_EMIT venueAddressChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const MessageMedia & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -5118,23 +6003,31 @@ Q_SIGNALS:
     void classTypeChanged();
 
 private:
-    AudioObject* _audio;
+    mutable AudioObject* _audio;
     QString _lastName;
     QString _firstName;
     QString _caption;
-    DocumentObject* _document;
-    GeoPointObject* _geo;
-    PhotoObject* _photo;
+    mutable DocumentObject* _document;
+    mutable GeoPointObject* _geo;
+    mutable PhotoObject* _photo;
     QString _phoneNumber;
     qint32 _userId;
-    VideoObject* _video;
-    WebPageObject* _webpage;
+    mutable VideoObject* _video;
+    mutable WebPageObject* _webpage;
     QString _venueTitle;
     QString _venueAddress;
     QByteArray _encryptKey;
     QByteArray _encryptIv;
     quint32 _classType;
 
+    /*! Sources of the child objects until they are first requested,
+     *  dropped once the child is built !*/
+    mutable Audio _audioValue;
+    mutable Document _documentValue;
+    mutable GeoPoint _geoValue;
+    mutable Photo _photoValue;
+    mutable Video _videoValue;
+    mutable WebPage _webpageValue;
 };
 
 Q_DECLARE_METATYPE(MessageMediaObject*)
@@ -5160,19 +6053,22 @@ class TELEGRAMQMLSHARED_EXPORT MessageObject : public TqObject
     Q_PROPERTY(quint32 classType READ classType WRITE setClassType NOTIFY classTypeChanged)
 
 public:
-    MessageObject(const Message & another, QObject *parent = 0) : TqObject(parent){
-        (void)another;
+    MessageObject(const Message & another, QObject *parent = 0) :
+        TqObject(parent),
+        _upload(0),
+        _toId(0),
+        _action(0),
+        _media(0),
+        _toIdValue(another.toId()),
+        _actionValue(another.action()),
+        _mediaValue(another.media()){
         _id = another.id();
         _sent = true;
         _encrypted = false;
-        _upload = new UploadObject(this);
-        _toId = new PeerObject(another.toId(), this);
         _unread = (another.flags() & 0x1);
-        _action = new MessageActionObject(another.action(), this);
         _fromId = another.fromId();
         _out = (another.flags() & 0x2);
         _date = another.date();
-        _media = new MessageMediaObject(another.media(), this);
         _fwdDate = another.fwdDate();
         _fwdFromId = another.fwdFromId();
         _replyToMsgId = another.replyToMsgId();
@@ -5225,6 +6121,8 @@ public:
     }
 
     UploadObject* upload() const {
+        if(!_upload)
+            _upload = new UploadObject(const_cast<MessageObject*>(this));
         return _upload;
     }
 
@@ -5237,6 +6135,11 @@ public:
     }
 
     PeerObject* toId() const {
+        if(!_toId)
+        {
+            _toId = new PeerObject(_toIdValue, const_cast<MessageObject*>(this));
+            _toIdValue = Peer();
+        }
         return _toId;
     }
 
@@ -5261,6 +6164,11 @@ public:
     }
 
     MessageActionObject* action() const {
+        if(!_action)
+        {
+            _action = new MessageActionObject(_actionValue, const_cast<MessageObject*>(this));
+            _actionValue = MessageAction();
+        }
         return _action;
     }
 
@@ -5309,6 +6217,11 @@ public:
     }
 
     MessageMediaObject* media() const {
+        if(!_media)
+        {
+            _media = new MessageMediaObject(_mediaValue, const_cast<MessageObject*>(this));
+            _mediaValue = MessageMedia();
+        }
         return _media;
     }
 
@@ -5381,36 +6294,88 @@ public:
     }
 
 
-    void operator= ( const Message & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _sent = true;
-        Q_EMIT sentChanged();
-        *_toId = another.toId();
-        Q_EMIT toIdChanged();
-        _unread = (another.flags() & 0x1);
-        Q_EMIT unreadChanged();
-        *_action = another.action();
-        Q_EMIT actionChanged();
-        _fromId = another.fromId();
-        Q_EMIT fromIdChanged();
-        _out = (another.flags() & 0x2);
-        Q_EMIT outChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        *_media = another.media();
-        Q_EMIT mediaChanged();
-        _fwdDate = another.fwdDate();
-        Q_EMIT fwdDateChanged();
-        _fwdFromId = another.fwdFromId();
-        Q_EMIT fwdFromIdChanged();
-        _replyToMsgId = another.replyToMsgId();
-        Q_EMIT replyToMsgIdChanged();
-        _message = another.message();
-        Q_EMIT messageChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const Message & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_sent != true) {
+            _sent = true;
+            Q_EMIT sentChanged();
+            modified = true;
+        }
+        if(!_toId)
+            _toIdValue = another.toId();
+        else
+        if(_toId->update(another.toId()))
+            modified = true;
+        const bool unread = (another.flags() & 0x1);
+        if(_unread != unread) {
+            _unread = unread;
+            Q_EMIT unreadChanged();
+            modified = true;
+        }
+        if(!_action)
+            _actionValue = another.action();
+        else
+        if(_action->update(another.action()))
+            modified = true;
+        if(_fromId != another.fromId()) {
+            _fromId = another.fromId();
+            Q_EMIT fromIdChanged();
+            modified = true;
+        }
+        const bool out = (another.flags() & 0x2);
+        if(_out != out) {
+            _out = out;
+            Q_EMIT outChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(!_media)
+            _mediaValue = another.media();
+        else
+        if(_media->update(another.media()))
+            modified = true;
+        if(_fwdDate != another.fwdDate()) {
+            _fwdDate = another.fwdDate();
+            Q_EMIT fwdDateChanged();
+            modified = true;
+        }
+        if(_fwdFromId != another.fwdFromId()) {
+            _fwdFromId = another.fwdFromId();
+            Q_EMIT fwdFromIdChanged();
+            modified = true;
+        }
+        if(_replyToMsgId != another.replyToMsgId()) {
+            _replyToMsgId = another.replyToMsgId();
+            Q_EMIT replyToMsgIdChanged();
+            modified = true;
+        }
+        if(_message != another.message()) {
+            _message = another.message();
+            Q_EMIT messageChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const Message & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -5436,20 +6401,25 @@ private:
     qint32 _id;
     bool _sent;
     bool _encrypted;
-    UploadObject* _upload;
-    PeerObject* _toId;
+    mutable UploadObject* _upload;
+    mutable PeerObject* _toId;
     bool _unread;
-    MessageActionObject* _action;
+    mutable MessageActionObject* _action;
     qint32 _fromId;
     bool _out;
     qint32 _date;
-    MessageMediaObject* _media;
+    mutable MessageMediaObject* _media;
     qint32 _fwdDate;
     qint32 _fwdFromId;
     qint32 _replyToMsgId;
     QString _message;
     quint32 _classType;
 
+    /*! Sources of the child objects until they are first requested,
+     *  dropped once the child is built !*/
+    mutable Peer _toIdValue;
+    mutable MessageAction _actionValue;
+    mutable MessageMedia _mediaValue;
 };
 
 Q_DECLARE_METATYPE(MessageObject*)
@@ -5582,24 +6552,50 @@ public:
     }
 
 
-    void operator= ( const GeoChatMessage & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        *_action = another.action();
-        Q_EMIT actionChanged();
-        _fromId = another.fromId();
-        Q_EMIT fromIdChanged();
-        _date = another.date();
-        Q_EMIT dateChanged();
-        *_media = another.media();
-        Q_EMIT mediaChanged();
-        _chatId = another.chatId();
-        Q_EMIT chatIdChanged();
-        _message = another.message();
-        Q_EMIT messageChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const GeoChatMessage & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_action->update(another.action()))
+            modified = true;
+        if(_fromId != another.fromId()) {
+            _fromId = another.fromId();
+            Q_EMIT fromIdChanged();
+            modified = true;
+        }
+        if(_date != another.date()) {
+            _date = another.date();
+            Q_EMIT dateChanged();
+            modified = true;
+        }
+        if(_media->update(another.media()))
+            modified = true;
+        if(_chatId != another.chatId()) {
+            _chatId = another.chatId();
+            Q_EMIT chatIdChanged();
+            modified = true;
+        }
+        if(_message != another.message()) {
+            _message = another.message();
+            Q_EMIT messageChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const GeoChatMessage & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -5769,26 +6765,55 @@ public:
     }
 
 
-    void operator= ( const User & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _phone = another.phone();
-        Q_EMIT phoneChanged();
-        _firstName = another.firstName();
-        Q_EMIT firstNameChanged();
-        *_photo = another.photo();
-        Q_EMIT photoChanged();
-        *_status = another.status();
-        Q_EMIT statusChanged();
-        _lastName = another.lastName();
-        Q_EMIT lastNameChanged();
-        _username = another.username();
-        Q_EMIT usernameChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const User & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_phone != another.phone()) {
+            _phone = another.phone();
+            Q_EMIT phoneChanged();
+            modified = true;
+        }
+        if(_firstName != another.firstName()) {
+            _firstName = another.firstName();
+            Q_EMIT firstNameChanged();
+            modified = true;
+        }
+        if(_photo->update(another.photo()))
+            modified = true;
+        if(_status->update(another.status()))
+            modified = true;
+        if(_lastName != another.lastName()) {
+            _lastName = another.lastName();
+            Q_EMIT lastNameChanged();
+            modified = true;
+        }
+        if(_username != another.username()) {
+            _username = another.username();
+            Q_EMIT usernameChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
+
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
 
+    void operator= ( const User & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -5902,18 +6927,41 @@ public:
     }
 
 
-    void operator= ( const StickerSet & another) {
-        _id = another.id();
-        Q_EMIT idChanged();
-        _accessHash = another.accessHash();
-        Q_EMIT accessHashChanged();
-        _title = another.title();
-        Q_EMIT titleChanged();
-        _shortName = another.shortName();
-        Q_EMIT shortNameChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const StickerSet & another) {
+        bool modified = false;
+        if(_id != another.id()) {
+            _id = another.id();
+            Q_EMIT idChanged();
+            modified = true;
+        }
+        if(_accessHash != another.accessHash()) {
+            _accessHash = another.accessHash();
+            Q_EMIT accessHashChanged();
+            modified = true;
+        }
+        if(_title != another.title()) {
+            _title = another.title();
+            Q_EMIT titleChanged();
+            modified = true;
+        }
+        if(_shortName != another.shortName()) {
+            _shortName = another.shortName();
+            Q_EMIT shortNameChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const StickerSet & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -5990,14 +7038,31 @@ public:
     }
 
 
-    void operator= ( const StickerPack & another) {
-        _emoticon = another.emoticon();
-        Q_EMIT emoticonChanged();
-        _documents = another.documents();
-        Q_EMIT documentsChanged();
-        _classType = another.classType();
-        Q_EMIT classTypeChanged();
+    bool update( const StickerPack & another) {
+        bool modified = false;
+        if(_emoticon != another.emoticon()) {
+            _emoticon = another.emoticon();
+            Q_EMIT emoticonChanged();
+            modified = true;
+        }
+        if(_documents != another.documents()) {
+            _documents = another.documents();
+            Q_EMIT documentsChanged();
+            modified = true;
+        }
+        if(_classType != another.classType()) {
+            _classType = another.classType();
+            Q_EMIT classTypeChanged();
+            modified = true;
+        }
 
+        if(modified)
+            Q_EMIT changed();
+        return modified;
+    }
+
+    void operator= ( const StickerPack & another) {
+        update(another);
     }
 
 Q_SIGNALS:
@@ -14,6 +14,7 @@ public:
 
     bool initializing;
     QString currentSet;
+    QString emoticon;
 
     QList<qint64> list;
     QStringList installedStickerSets;
@@ -73,11 +74,7 @@ void StickersModel::recheck()
     if( !p->telegram || !p->telegram->authLoggedIn() )
         return;
 
-    Telegram *tg = p->telegram->telegram();
-    if(!tg)
-        return;
-
-    tg->messagesGetAllStickers(QString());
+    p->telegram->messagesGetAllStickers();
     if(!p->currentSet.isEmpty() && !p->currentSet.toLongLong() && p->currentSet != "0")
         p->telegram->getStickerSet(p->currentSet);
 }
@@ -97,6 +94,21 @@ void StickersModel::setCurrentStickerSet(const QString &cat)
     Q_EMIT currentStickerSetChanged();
 }
 
+QString StickersModel::emoticon() const
+{
+    return p->emoticon;
+}
+
+void StickersModel::setEmoticon(const QString &emoticon)
+{
+    if(p->emoticon == emoticon)
+        return;
+
+    p->emoticon = emoticon;
+    listChanged(true);
+    Q_EMIT emoticonChanged();
+}
+
 QStringList StickersModel::installedStickerSets() const
 {
     return p->installedStickerSets;
@@ -161,6 +173,13 @@ QVariant StickersModel::data(const QModelIndex &index, int role) const
         break;
 
     case emoticonRole:
+        if(p->telegram)
+        {
+            const QList<DocumentAttribute> &attrs = p->telegram->sticker(sid)->attributes();
+            Q_FOREACH(const DocumentAttribute &attr, attrs)
+                if(attr.classType() == DocumentAttribute::typeDocumentAttributeSticker)
+                    result = attr.alt();
+        }
         break;
 
     case stickerSetNameRole:
@@ -233,53 +252,7 @@ void StickersModel::listChanged(bool cached)
     const QList<qint64> &list = getList(p->currentSet);
 
     const int firstCount = p->list.count();
-    for( int i=0 ; i<p->list.count() ; i++ )
-    {
-        const qint64 dId = p->list.at(i);
-        if( list.contains(dId) )
-            continue;
-
-        beginRemoveRows(QModelIndex(), i, i);
-        p->list.removeAt(i);
-        i--;
-        endRemoveRows();
-    }
-
-
-    QList<qint64> temp_msgs = list;
-    for( int i=0 ; i<temp_msgs.count() ; i++ )
-    {
-        const qint64 dId = temp_msgs.at(i);
-        if( p->list.contains(dId) )
-            continue;
-
-        temp_msgs.removeAt(i);
-        i--;
-    }
-    while( p->list != temp_msgs )
-        for( int i=0 ; i<p->list.count() ; i++ )
-        {
-            const qint64 dId = p->list.at(i);
-            int nw = temp_msgs.indexOf(dId);
-            if( i == nw )
-                continue;
-
-            beginMoveRows( QModelIndex(), i, i, QModelIndex(), nw>i?nw+1:nw );
-            p->list.move( i, nw );
-            endMoveRows();
-        }
-
-
-    for( int i=0 ; i<list.count() ; i++ )
-    {
-        const qint64 dId = list.at(i);
-        if( p->list.contains(dId) )
-            continue;
-
-        beginInsertRows(QModelIndex(), i, i );
-        p->list.insert( i, dId );
-        endInsertRows();
-    }
+    syncList(p->list, list);
 
     if(firstCount != p->list.count())
         Q_EMIT countChanged();
@@ -303,6 +276,9 @@ InputStickerSet StickersModel::stickerOfDocument(DocumentObject *obj) const
 QList<qint64> StickersModel::getList(const QString &id)
 {
     QList<qint64> list;
+    if(!p->emoticon.isEmpty())
+        return p->telegram->stickersOfEmoticon(p->emoticon);
+    else
     if(id.toLongLong() || id == "0")
         list = p->telegram->stickerSetDocuments(id.toLongLong());
     else
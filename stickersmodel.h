@@ -17,6 +17,7 @@ class TELEGRAMQMLSHARED_EXPORT StickersModel : public TgAbstractListModel
 
     Q_PROPERTY(TelegramQml* telegram READ telegram WRITE setTelegram NOTIFY telegramChanged)
     Q_PROPERTY(QString currentStickerSet READ currentStickerSet WRITE setCurrentStickerSet NOTIFY currentStickerSetChanged)
+    Q_PROPERTY(QString emoticon READ emoticon WRITE setEmoticon NOTIFY emoticonChanged)
     Q_PROPERTY(int count READ count NOTIFY countChanged)
     Q_PROPERTY(bool initializing READ initializing NOTIFY initializingChanged)
     Q_PROPERTY(QStringList installedStickerSets READ installedStickerSets NOTIFY installedStickerSetsChanged)
@@ -41,6 +42,9 @@ public:
     QString currentStickerSet() const;
     void setCurrentStickerSet(const QString &cat);
 
+    QString emoticon() const;
+    void setEmoticon(const QString &emoticon);
+
     QStringList installedStickerSets() const;
     QStringList stickerSets() const;
     Q_INVOKABLE DocumentObject *stickerSetThumbnailDocument(const QString &id) const;
@@ -64,6 +68,7 @@ Q_SIGNALS:
     void countChanged();
     void initializingChanged();
     void currentStickerSetChanged();
+    void emoticonChanged();
     void installedStickerSetsChanged();
     void stickerSetsChanged();
 
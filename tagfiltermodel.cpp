@@ -127,53 +127,7 @@ void TagFilterModel::listChanged()
         i--;
     }
 
-    for( int i=0 ; i<p->tags.count() ; i++ )
-    {
-        const QString &tag = p->tags.at(i);
-        if( tags.contains(tag) )
-            continue;
-
-        beginRemoveRows(QModelIndex(), i, i);
-        p->tags.removeAt(i);
-        i--;
-        endRemoveRows();
-    }
-
-
-    QStringList temp_tags = tags;
-    for( int i=0 ; i<temp_tags.count() ; i++ )
-    {
-        const QString &tag = temp_tags.at(i);
-        if( p->tags.contains(tag) )
-            continue;
-
-        temp_tags.removeAt(i);
-        i--;
-    }
-    while( p->tags != temp_tags )
-        for( int i=0 ; i<p->tags.count() ; i++ )
-        {
-            const QString &tag = p->tags.at(i);
-            int nw = temp_tags.indexOf(tag);
-            if( i == nw )
-                continue;
-
-            beginMoveRows( QModelIndex(), i, i, QModelIndex(), nw>i?nw+1:nw );
-            p->tags.move( i, nw );
-            endMoveRows();
-        }
-
-
-    for( int i=0 ; i<tags.count() ; i++ )
-    {
-        const QString &tag = tags.at(i);
-        if( p->tags.contains(tag) )
-            continue;
-
-        beginInsertRows(QModelIndex(), i, i );
-        p->tags.insert( i, tag );
-        endInsertRows();
-    }
+    syncList(p->tags, tags);
 
     Q_EMIT countChanged();
 }
@@ -16,10 +16,9 @@
 */
 
 
-#include <QRegExp>
-
 #include "telegramdetailedcontactsmodel.h"
 #include "telegramcontactsfiltermodel.h"
+#include "telegramqml.h"
 
 TelegramContactsFilterModel::TelegramContactsFilterModel(QObject *parent) :
         QSortFilterProxyModel(parent), mOwnId(0), mSearchTerm("")
@@ -33,11 +32,15 @@ TelegramContactsFilterModel::~TelegramContactsFilterModel()
 bool TelegramContactsFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
     QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
 
-    QString fullName = sourceModel()->data(index, TelegramDetailedContactsModel::FullNameRole).toString();
     qint32 id = sourceModel()->data(index, TelegramDetailedContactsModel::IdRole).toInt();
-
-    bool notSelf = (id != mOwnId);
-    return notSelf && (fullName.contains(filterRegExp()));
+    if (id == mOwnId)
+        return false;
+    if (mSearchKey.isEmpty())
+        return true;
+
+    /*! Word prefix match on the same normalized form the source model uses !*/
+    const QString searchKey = sourceModel()->data(index, TelegramDetailedContactsModel::SearchKeyRole).toString();
+    return searchKey.startsWith(mSearchKey) || searchKey.contains(" " + mSearchKey);
 }
 
 QString TelegramContactsFilterModel::searchTerm() const
@@ -49,10 +52,8 @@ void TelegramContactsFilterModel::setSearchTerm(const QString &searchTerm)
 {
     if (mSearchTerm != searchTerm) {
         mSearchTerm = searchTerm;
-
-        QString pattern = QString("\\b%1").arg(searchTerm);
-        setFilterKeyColumn(0);
-        setFilterRegExp(QRegExp(pattern, Qt::CaseInsensitive));
+        mSearchKey = TelegramQml::normalizeName(searchTerm);
+        invalidateFilter();
 
         Q_EMIT searchTermChanged();
     }
@@ -48,6 +48,7 @@ Q_SIGNALS:
 private:
     qint64 mOwnId;
     QString mSearchTerm;
+    QString mSearchKey;
 };
 
 #endif // TELEGRAMCONTACTSFILTERMODEL_H
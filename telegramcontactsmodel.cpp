@@ -22,12 +22,14 @@
 
 #include <telegram.h>
 #include <QPointer>
+#include <QSet>
 
 class TelegramContactsModelPrivate
 {
 public:
     QPointer<TelegramQml> telegram;
     QList<qint64> contacts;
+    QSet<qint64> contactsSet;
     bool initializing;
 };
 
@@ -52,6 +54,7 @@ void TelegramContactsModel::setTelegram(TelegramQml *tgo)
     if(p->telegram)
     {
         disconnect(p->telegram, SIGNAL(contactsChanged()), this, SLOT(contactsChanged()));
+        disconnect(p->telegram, SIGNAL(userRenamed(qint64)), this, SLOT(userRenamed(qint64)));
         disconnect(p->telegram, SIGNAL(authLoggedInChanged()), this, SLOT(recheck()));
     }
 
@@ -59,6 +62,7 @@ void TelegramContactsModel::setTelegram(TelegramQml *tgo)
     if(p->telegram)
     {
         connect(p->telegram, SIGNAL(contactsChanged()), this, SLOT(contactsChanged()));
+        connect(p->telegram, SIGNAL(userRenamed(qint64)), this, SLOT(userRenamed(qint64)));
         connect(p->telegram, SIGNAL(authLoggedInChanged()), this, SLOT(recheck()), Qt::QueuedConnection);
     }
 
@@ -129,9 +133,8 @@ void TelegramContactsModel::recheck()
 {
     if( !p->telegram || !p->telegram->authLoggedIn() )
         return;
-    Telegram *tg = p->telegram->telegram();
-    if(tg)
-        tg->contactsGetContacts();
+
+    p->telegram->contactsGetContacts();
 }
 
 void TelegramContactsModel::contactsChanged()
@@ -139,28 +142,30 @@ void TelegramContactsModel::contactsChanged()
     if(!p->telegram)
         return;
 
-    const QList<qint64> & contacts_unsort = p->telegram->contacts();
-    QMap<QString,qint64> sort_map;
-    Q_FOREACH( qint64 id, contacts_unsort )
-    {
-        UserObject *user = p->telegram->user(id);
-        sort_map.insertMulti( user->firstName() + " " + user->lastName(), id );
-    }
+    const QList<qint64> & contacts = p->telegram->contacts();
+    const QSet<qint64> & contactsSet = contacts.toSet();
 
-    const QList<qint64> & contacts = sort_map.values();
+    for( int i=p->contacts.count()-1 ; i>=0 ; i-- )
+    {
+        const qint64 uId = p->contacts.at(i);
+        if( contactsSet.contains(uId) )
+            continue;
 
-    beginResetModel();
-    p->contacts.clear();
-    endResetModel();
+        beginRemoveRows(QModelIndex(), i, i);
+        p->contacts.removeAt(i);
+        p->contactsSet.remove(uId);
+        endRemoveRows();
+    }
 
-    for( int i=0 ; i<contacts.count() ; i++ )
+    Q_FOREACH( qint64 uId, contacts )
     {
-        const qint64 dId = contacts.at(i);
-        if( p->contacts.contains(dId) )
+        if( p->contactsSet.contains(uId) )
             continue;
 
-        beginInsertRows(QModelIndex(), i, i );
-        p->contacts.insert( i, dId );
+        const int row = sortPosition(uId);
+        beginInsertRows(QModelIndex(), row, row );
+        p->contacts.insert( row, uId );
+        p->contactsSet.insert( uId );
         endInsertRows();
     }
 
@@ -168,6 +173,41 @@ void TelegramContactsModel::contactsChanged()
     Q_EMIT initializingChanged();
 }
 
+void TelegramContactsModel::userRenamed(qint64 uId)
+{
+    if( !p->contactsSet.contains(uId) )
+        return;
+
+    const int row = p->contacts.indexOf(uId);
+    p->contacts.removeAt(row);
+    const int pos = sortPosition(uId);
+    p->contacts.insert(row, uId);
+    if( pos == row )
+        return;
+
+    beginMoveRows(QModelIndex(), row, row, QModelIndex(), pos>row? pos+1 : pos);
+    p->contacts.move(row, pos);
+    endMoveRows();
+}
+
+int TelegramContactsModel::sortPosition(qint64 uId) const
+{
+    const QCollatorSortKey &key = p->telegram->userSortKey(uId);
+
+    int low = 0;
+    int high = p->contacts.count();
+    while( low < high )
+    {
+        const int mid = (low+high)/2;
+        if( key.compare(p->telegram->userSortKey(p->contacts.at(mid))) < 0 )
+            high = mid;
+        else
+            low = mid+1;
+    }
+
+    return low;
+}
+
 TelegramContactsModel::~TelegramContactsModel()
 {
     delete p;
@@ -65,8 +65,11 @@ Q_SIGNALS:
 private Q_SLOTS:
     void recheck();
     void contactsChanged();
+    void userRenamed(qint64 uId);
 
 private:
+    int sortPosition(qint64 uId) const;
+
     TelegramContactsModelPrivate *p;
 };
 
@@ -22,12 +22,14 @@
 
 #include <telegram.h>
 #include <QPointer>
+#include <QSet>
 
 class TelegramDetailedContactsModelPrivate
 {
 public:
     QPointer<TelegramQml> telegram;
     QList<qint64> contacts;
+    QSet<qint64> contactsSet;
     bool initializing;
 };
 
@@ -51,6 +53,7 @@ void TelegramDetailedContactsModel::setTelegram(TelegramQml *tgo)
     if(p->telegram)
     {
         disconnect(p->telegram, SIGNAL(contactsChanged()), this, SLOT(contactsChanged()));
+        disconnect(p->telegram, SIGNAL(userRenamed(qint64)), this, SLOT(userRenamed(qint64)));
         disconnect(p->telegram, SIGNAL(authLoggedInChanged()), this, SLOT(recheck()));
         disconnect(p->telegram, SIGNAL(connectedChanged()), this, SLOT(recheck()));
     }
@@ -59,6 +62,7 @@ void TelegramDetailedContactsModel::setTelegram(TelegramQml *tgo)
     if(p->telegram)
     {
         connect(p->telegram, SIGNAL(contactsChanged()), this, SLOT(contactsChanged()));
+        connect(p->telegram, SIGNAL(userRenamed(qint64)), this, SLOT(userRenamed(qint64)));
         connect(p->telegram, SIGNAL(authLoggedInChanged()), this, SLOT(recheck()), Qt::QueuedConnection);
         connect(p->telegram, SIGNAL(connectedChanged()), this, SLOT(recheck()), Qt::QueuedConnection);
     }
@@ -122,6 +126,9 @@ QVariant TelegramDetailedContactsModel::data(const QModelIndex &index, int role)
     case StatusRole:
         res = QVariant::fromValue<UserStatusObject*>(user->status());
         break;
+    case SearchKeyRole:
+        res = p->telegram->userSearchKey(key);
+        break;
     }
 
     return res;
@@ -144,6 +151,7 @@ QHash<qint32, QByteArray> TelegramDetailedContactsModel::roleNames() const
     res->insert(UsernameRole, "username");
     res->insert(PhotoRole, "photo");
     res->insert(StatusRole, "status");
+    res->insert(SearchKeyRole, "searchKey");
     return *res;
 }
 
@@ -173,42 +181,90 @@ void TelegramDetailedContactsModel::recheck()
 {
     if( !p->telegram || !p->telegram->authLoggedIn() )
         return;
-    Telegram *tg = p->telegram->telegram();
-    if(tg && tg->isConnected())
-        tg->contactsGetContacts();
+
+    p->telegram->contactsGetContacts();
 }
 
 void TelegramDetailedContactsModel::contactsChanged()
 {
-    const QList<qint64> & contacts_unsort = p->telegram->contacts();
-    QMap<QString,qint64> sort_map;
-    Q_FOREACH( qint64 id, contacts_unsort )
-    {
-        UserObject *user = p->telegram->user(id);
-        sort_map.insertMulti( user->firstName() + " " + user->lastName(), id );
-    }
+    if( !p->telegram )
+        return;
+
+    const QList<qint64> & contacts = p->telegram->contacts();
+    const QSet<qint64> & contactsSet = contacts.toSet();
+    const int oldCount = p->contacts.count();
 
-    const QList<qint64> & contacts = sort_map.values();
+    for( int i=p->contacts.count()-1 ; i>=0 ; i-- )
+    {
+        const qint64 uId = p->contacts.at(i);
+        if( contactsSet.contains(uId) )
+            continue;
 
-    beginResetModel();
-    p->contacts.clear();
-    endResetModel();
+        beginRemoveRows(QModelIndex(), i, i);
+        p->contacts.removeAt(i);
+        p->contactsSet.remove(uId);
+        endRemoveRows();
+    }
 
-    for( int i=0 ; i<contacts.count() ; i++ )
+    Q_FOREACH( qint64 uId, contacts )
     {
-        const qint64 dId = contacts.at(i);
-        if( p->contacts.contains(dId) )
+        if( p->contactsSet.contains(uId) )
             continue;
 
-        beginInsertRows(QModelIndex(), i, i );
-        p->contacts.insert( i, dId );
+        const int row = sortPosition(uId);
+        beginInsertRows(QModelIndex(), row, row );
+        p->contacts.insert( row, uId );
+        p->contactsSet.insert( uId );
         endInsertRows();
     }
 
+    if( oldCount != p->contacts.count() )
+        Q_EMIT countChanged();
+
     p->initializing = false;
     Q_EMIT initializingChanged();
 }
 
+void TelegramDetailedContactsModel::userRenamed(qint64 uId)
+{
+    if( !p->contactsSet.contains(uId) )
+        return;
+
+    const int row = p->contacts.indexOf(uId);
+    p->contacts.removeAt(row);
+    const int pos = sortPosition(uId);
+    p->contacts.insert(row, uId);
+
+    if( pos != row )
+    {
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), pos>row? pos+1 : pos);
+        p->contacts.move(row, pos);
+        endMoveRows();
+    }
+
+    const QModelIndex &idx = index(pos);
+    Q_EMIT dataChanged(idx, idx, QVector<int>() << FirstNameRole << LastNameRole << FullNameRole << SearchKeyRole);
+}
+
+/*! Binary search on the cached collation keys of the telegram object !*/
+int TelegramDetailedContactsModel::sortPosition(qint64 uId) const
+{
+    const QCollatorSortKey &key = p->telegram->userSortKey(uId);
+
+    int low = 0;
+    int high = p->contacts.count();
+    while( low < high )
+    {
+        const int mid = (low+high)/2;
+        if( key.compare(p->telegram->userSortKey(p->contacts.at(mid))) < 0 )
+            high = mid;
+        else
+            low = mid+1;
+    }
+
+    return low;
+}
+
 TelegramDetailedContactsModel::~TelegramDetailedContactsModel()
 {
     delete p;
@@ -44,7 +44,8 @@ public:
         FullNameRole,
         UsernameRole,
         PhotoRole,
-        StatusRole
+        StatusRole,
+        SearchKeyRole
     };
 
     TelegramDetailedContactsModel(QObject *parent = 0);
@@ -74,6 +75,10 @@ Q_SIGNALS:
 private Q_SLOTS:
     void recheck();
     void contactsChanged();
+    void userRenamed(qint64 uId);
+
+private:
+    int sortPosition(qint64 uId) const;
 
 private:
     TelegramDetailedContactsModelPrivate *p;
@@ -24,6 +24,23 @@
 
 #include <telegram.h>
 #include <QPointer>
+#include <QVector>
+
+/*! Flat presentation values of a dialog row, refreshed on every dialogs
+ *  change and compared so only the roles that really moved are signalled !*/
+class TelegramDialogsModelRow
+{
+public:
+    qint64 titleUserId;
+    qint32 messageFromId;
+    QString title;
+    QString messageText;
+    qint32 messageDate;
+    QString messageFromName;
+    bool messageOut;
+    quint32 messageMediaType;
+    qint32 unreadCount;
+};
 
 class TelegramDialogsModelPrivate
 {
@@ -35,6 +52,7 @@ public:
     int refresh_timer;
 
     QList<qint64> dialogs;
+    QHash<qint64, TelegramDialogsModelRow> rows;
 };
 
 TelegramDialogsModel::TelegramDialogsModel(QObject *parent) :
@@ -61,6 +79,9 @@ void TelegramDialogsModel::setTelegram(TelegramQml *tgo)
     {
         disconnect( p->telegram, SIGNAL(dialogsChanged(bool)), this, SLOT(dialogsChanged(bool)) );
         disconnect( p->telegram, SIGNAL(phoneNumberChanged()), this, SLOT(refreshDatabase()) );
+        disconnect( p->telegram, SIGNAL(userRenamed(qint64)), this, SLOT(userRenamed(qint64)) );
+        disconnect( p->telegram, SIGNAL(chatRenamed(qint64)), this, SLOT(chatRenamed(qint64)) );
+        disconnect( p->telegram, SIGNAL(messageUpdated(qint64,qint64)), this, SLOT(messageUpdated(qint64,qint64)) );
 
         disconnect( p->telegram->userData(), SIGNAL(favoriteChanged(int)) , this, SLOT(userDataChanged()) );
         disconnect( p->telegram->userData(), SIGNAL(valueChanged(QString)), this, SLOT(userDataChanged()) );
@@ -70,11 +91,15 @@ void TelegramDialogsModel::setTelegram(TelegramQml *tgo)
     }
 
     p->telegram = tgo;
+    p->rows.clear();
     p->initializing = tgo;
     if( p->telegram )
     {
         connect( p->telegram, SIGNAL(dialogsChanged(bool)), SLOT(dialogsChanged(bool)) );
         connect( p->telegram, SIGNAL(phoneNumberChanged()), SLOT(refreshDatabase()), Qt::QueuedConnection );
+        connect( p->telegram, SIGNAL(userRenamed(qint64)), SLOT(userRenamed(qint64)) );
+        connect( p->telegram, SIGNAL(chatRenamed(qint64)), SLOT(chatRenamed(qint64)) );
+        connect( p->telegram, SIGNAL(messageUpdated(qint64,qint64)), SLOT(messageUpdated(qint64,qint64)) );
 
         connect( p->telegram->userData(), SIGNAL(favoriteChanged(int)) , this, SLOT(userDataChanged()) );
         connect( p->telegram->userData(), SIGNAL(valueChanged(QString)), this, SLOT(userDataChanged()) );
@@ -131,11 +156,145 @@ QVariant TelegramDialogsModel::data(const QModelIndex &index, int role) const
     case SectionRole:
         res = p->telegram->userData()->value("love").toLongLong()==key? 2 : (p->telegram->userData()->isFavorited(key)? 1 : 0);
         break;
+
+    case TitleRole:
+        res = cachedRow(key).title;
+        break;
+
+    case MessageTextRole:
+        res = cachedRow(key).messageText;
+        break;
+
+    case MessageDateRole:
+        res = cachedRow(key).messageDate;
+        break;
+
+    case MessageFromNameRole:
+        res = cachedRow(key).messageFromName;
+        break;
+
+    case MessageOutRole:
+        res = cachedRow(key).messageOut;
+        break;
+
+    case MessageMediaTypeRole:
+        res = cachedRow(key).messageMediaType;
+        break;
+
+    case UnreadCountRole:
+        res = cachedRow(key).unreadCount;
+        break;
     }
 
     return res;
 }
 
+TelegramDialogsModelRow TelegramDialogsModel::createRow(qint64 dId) const
+{
+    DialogObject *dialog = p->telegram->dialog(dId);
+    MessageObject *msg = p->telegram->message(dialog->topMessage());
+
+    TelegramDialogsModelRow row;
+    row.titleUserId = 0;
+    if(dialog->encrypted())
+    {
+        EncryptedChatObject *chat = p->telegram->encryptedChat(dId);
+        row.titleUserId = chat->adminId()==p->telegram->me()? chat->participantId() : chat->adminId();
+    }
+    else
+    if(!dialog->peer()->chatId())
+        row.titleUserId = dialog->peer()->userId();
+
+    if(row.titleUserId)
+        row.title = p->telegram->userDisplayName(row.titleUserId);
+    else
+        row.title = p->telegram->chat(dialog->peer()->chatId())->title();
+
+    row.messageText = msg->message();
+    row.messageDate = msg->date();
+    row.messageFromId = msg->fromId();
+    row.messageFromName = p->telegram->userDisplayName(row.messageFromId);
+    row.messageOut = msg->out();
+    row.messageMediaType = msg->media()->classType();
+    row.unreadCount = dialog->unreadCount();
+    return row;
+}
+
+const TelegramDialogsModelRow &TelegramDialogsModel::cachedRow(qint64 dId) const
+{
+    QHash<qint64, TelegramDialogsModelRow>::iterator i = p->rows.find(dId);
+    if(i == p->rows.end())
+        i = p->rows.insert(dId, createRow(dId));
+
+    return i.value();
+}
+
+/*! Rebuilds the cached row at index i and signals the roles that moved !*/
+void TelegramDialogsModel::refreshRow(int i)
+{
+    const qint64 dId = p->dialogs.at(i);
+    QHash<qint64, TelegramDialogsModelRow>::iterator it = p->rows.find(dId);
+    if(it == p->rows.end())
+        return;
+
+    const TelegramDialogsModelRow &row = createRow(dId);
+    TelegramDialogsModelRow &old = it.value();
+    QVector<int> roles;
+    if(old.title != row.title)
+        roles << TitleRole;
+    if(old.messageText != row.messageText)
+        roles << MessageTextRole;
+    if(old.messageDate != row.messageDate)
+        roles << MessageDateRole;
+    if(old.messageFromName != row.messageFromName)
+        roles << MessageFromNameRole;
+    if(old.messageOut != row.messageOut)
+        roles << MessageOutRole;
+    if(old.messageMediaType != row.messageMediaType)
+        roles << MessageMediaTypeRole;
+    if(old.unreadCount != row.unreadCount)
+        roles << UnreadCountRole;
+
+    old = row;
+    if(roles.isEmpty())
+        return;
+
+    const QModelIndex &idx = index(i);
+    Q_EMIT dataChanged(idx, idx, roles);
+}
+
+void TelegramDialogsModel::userRenamed(qint64 userId)
+{
+    for(int i=0; i<p->dialogs.count(); i++)
+    {
+        QHash<qint64, TelegramDialogsModelRow>::const_iterator it = p->rows.constFind(p->dialogs.at(i));
+        if(it == p->rows.constEnd())
+            continue;
+        if(it.value().titleUserId == userId || it.value().messageFromId == userId)
+            refreshRow(i);
+    }
+}
+
+void TelegramDialogsModel::chatRenamed(qint64 chatId)
+{
+    if(!p->rows.contains(chatId))
+        return;
+
+    const int row = p->dialogs.indexOf(chatId);
+    if(row != -1)
+        refreshRow(row);
+}
+
+void TelegramDialogsModel::messageUpdated(qint64 msgId, qint64 dId)
+{
+    if(!p->rows.contains(dId) || p->telegram->dialog(dId)->topMessage() != msgId)
+        return;
+
+    const int row = p->dialogs.indexOf(dId);
+    if(row != -1)
+        refreshRow(row);
+}
+
 QHash<qint32, QByteArray> TelegramDialogsModel::roleNames() const
 {
     static QHash<qint32, QByteArray> *res = 0;
@@ -145,6 +304,13 @@ QHash<qint32, QByteArray> TelegramDialogsModel::roleNames() const
     res = new QHash<qint32, QByteArray>();
     res->insert( ItemRole, "item");
     res->insert( SectionRole, "section");
+    res->insert( TitleRole, "title");
+    res->insert( MessageTextRole, "messageText");
+    res->insert( MessageDateRole, "messageDate");
+    res->insert( MessageFromNameRole, "messageFromName");
+    res->insert( MessageOutRole, "messageOut");
+    res->insert( MessageMediaTypeRole, "messageMediaType");
+    res->insert( UnreadCountRole, "unreadCount");
     return *res;
 }
 
@@ -197,9 +363,7 @@ void TelegramDialogsModel::recheck()
     if(!p->telegram->authLoggedIn())
         return;
 
-    Telegram *tgObject = p->telegram->telegram();
-    if(tgObject && tgObject->isConnected())
-        tgObject->messagesGetDialogs(0,0,1000);
+    p->telegram->messagesGetDialogs();
 }
 
 void TelegramDialogsModel::dialogsChanged(bool cachedData)
@@ -226,53 +390,14 @@ void TelegramDialogsModel::dialogsChanged_priv()
 
     const QList<qint64> & dialogs = fixDialogs(p->telegram->dialogs());
 
-    for( int i=0 ; i<p->dialogs.count() ; i++ )
-    {
-        const qint64 dId = p->dialogs.at(i);
-        if( dialogs.contains(dId) )
-            continue;
+    QList<qint64> removed;
+    syncList(p->dialogs, dialogs, &removed);
+    Q_FOREACH(qint64 dId, removed)
+        p->rows.remove(dId);
 
-        beginRemoveRows(QModelIndex(), i, i);
-        p->dialogs.removeAt(i);
-        i--;
-        endRemoveRows();
-    }
-
-
-    QList<qint64> temp_msgs = dialogs;
-    for( int i=0 ; i<temp_msgs.count() ; i++ )
-    {
-        const qint64 dId = temp_msgs.at(i);
-        if( p->dialogs.contains(dId) )
-            continue;
-
-        temp_msgs.removeAt(i);
-        i--;
-    }
-    while( p->dialogs != temp_msgs )
-        for( int i=0 ; i<p->dialogs.count() ; i++ )
-        {
-            const qint64 dId = p->dialogs.at(i);
-            int nw = temp_msgs.indexOf(dId);
-            if( i == nw )
-                continue;
-
-            beginMoveRows( QModelIndex(), i, i, QModelIndex(), nw>i?nw+1:nw );
-            p->dialogs.move( i, nw );
-            endMoveRows();
-        }
-
-
-    for( int i=0 ; i<dialogs.count() ; i++ )
-    {
-        const qint64 dId = dialogs.at(i);
-        if( p->dialogs.contains(dId) )
-            continue;
-
-        beginInsertRows(QModelIndex(), i, i );
-        p->dialogs.insert( i, dId );
-        endInsertRows();
-    }
+    /*! Only rows a delegate has already read are cached, refresh those !*/
+    for(int i=0; i<p->dialogs.count(); i++)
+        refreshRow(i);
 
     Q_EMIT countChanged();
 }
@@ -283,6 +408,7 @@ void TelegramDialogsModel::userDataChanged()
 
     beginResetModel();
     p->dialogs.clear();
+    p->rows.clear();
     endResetModel();
 
     for( int i=0 ; i<dialogs.count() ; i++ )
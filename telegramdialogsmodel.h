@@ -25,6 +25,7 @@
 class DialogObject;
 class TelegramQml;
 class TelegramDialogsModelPrivate;
+class TelegramDialogsModelRow;
 class TELEGRAMQMLSHARED_EXPORT TelegramDialogsModel : public TgAbstractListModel
 {
     Q_OBJECT
@@ -38,7 +39,14 @@ class TELEGRAMQMLSHARED_EXPORT TelegramDialogsModel : public TgAbstractListModel
 public:
     enum DialogsRoles {
         ItemRole = Qt::UserRole,
-        SectionRole
+        SectionRole,
+        TitleRole,
+        MessageTextRole,
+        MessageDateRole,
+        MessageFromNameRole,
+        MessageOutRole,
+        MessageMediaTypeRole,
+        UnreadCountRole
     };
 
     TelegramDialogsModel(QObject *parent = 0);
@@ -77,6 +85,9 @@ private Q_SLOTS:
     void dialogsChanged(bool cachedData);
     void dialogsChanged_priv();
     void userDataChanged();
+    void userRenamed(qint64 userId);
+    void chatRenamed(qint64 chatId);
+    void messageUpdated(qint64 msgId, qint64 dId);
 
     QList<qint64> fixDialogs(QList<qint64> dialogs );
 
@@ -84,6 +95,10 @@ protected:
     void timerEvent(QTimerEvent *e);
 
 private:
+    TelegramDialogsModelRow createRow(qint64 dId) const;
+    const TelegramDialogsModelRow &cachedRow(qint64 dId) const;
+    void refreshRow(int i);
+
     TelegramDialogsModelPrivate *p;
 };
 
@@ -0,0 +1,183 @@
+#include "telegramfileindex.h"
+
+#include <QThread>
+#include <QHash>
+#include <QSet>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+
+class TelegramFileIndexPrivate
+{
+public:
+    QThread *thread;
+    TelegramFileIndexCore *core;
+    QFileSystemWatcher *watcher;
+
+    QHash<QString, QHash<QString,TelegramFileIndexEntry> > dirs;
+    QHash<QString, int> refs;
+    QSet<QString> scanning;
+    QSet<QString> dirty;
+};
+
+TelegramFileIndex::TelegramFileIndex(QObject *parent) :
+    QObject(parent)
+{
+    p = new TelegramFileIndexPrivate;
+    p->core = new TelegramFileIndexCore();
+    p->thread = new QThread(this);
+    p->thread->start();
+
+    p->core->moveToThread(p->thread);
+
+    p->watcher = new QFileSystemWatcher(this);
+
+    connect(p->watcher, SIGNAL(directoryChanged(QString)), SLOT(directoryChanged(QString)));
+    connect(p->core, SIGNAL(directoryScanned(QString,QList<TelegramFileIndexEntry>)),
+            SLOT(directoryScanned(QString,QList<TelegramFileIndexEntry>)), Qt::QueuedConnection);
+    connect(p->core, SIGNAL(fileScanned(QString,TelegramFileIndexEntry)),
+            SLOT(fileScanned(QString,TelegramFileIndexEntry)), Qt::QueuedConnection);
+    connect(p->core, SIGNAL(fileMissing(QString,QString)),
+            SLOT(fileMissing(QString,QString)), Qt::QueuedConnection);
+}
+
+/*! Directories are indexed while at least one model watches them. The
+ *  first watcher starts a background scan, later ones share the result. !*/
+void TelegramFileIndex::watch(const QString &path)
+{
+    int &refs = p->refs[path];
+    refs++;
+    if(refs != 1)
+        return;
+
+    if(QFileInfo(path).isDir())
+        p->watcher->addPath(path);
+
+    directoryChanged(path);
+}
+
+void TelegramFileIndex::unwatch(const QString &path)
+{
+    QHash<QString,int>::iterator i = p->refs.find(path);
+    if(i == p->refs.end())
+        return;
+
+    i.value()--;
+    if(i.value() > 0)
+        return;
+
+    p->refs.erase(i);
+    p->dirs.remove(path);
+    p->watcher->removePath(path);
+}
+
+bool TelegramFileIndex::indexed(const QString &path) const
+{
+    return p->dirs.contains(path);
+}
+
+QStringList TelegramFileIndex::files(const QString &path) const
+{
+    return p->dirs.value(path).keys();
+}
+
+TelegramFileIndexEntry TelegramFileIndex::entry(const QString &path, const QString &name) const
+{
+    return p->dirs.value(path).value(name);
+}
+
+/*! Called by the download path when a file is complete, so the index
+ *  doesn't have to wait for the watcher (or the directory to exist) !*/
+void TelegramFileIndex::updateFile(const QString &filePath)
+{
+    const QFileInfo info(filePath);
+    const QString &path = info.absolutePath();
+    if(!p->refs.contains(path))
+        return;
+
+    if(!p->watcher->directories().contains(path))
+        p->watcher->addPath(path);
+
+    QMetaObject::invokeMethod(p->core, "scanFile", Qt::QueuedConnection, Q_ARG(QString,path), Q_ARG(QString,info.fileName()));
+}
+
+void TelegramFileIndex::directoryChanged(const QString &path)
+{
+    if(p->scanning.contains(path))
+    {
+        p->dirty.insert(path);
+        return;
+    }
+
+    p->scanning.insert(path);
+    QMetaObject::invokeMethod(p->core, "scanDirectory", Qt::QueuedConnection, Q_ARG(QString,path));
+}
+
+void TelegramFileIndex::directoryScanned(const QString &path, const QList<TelegramFileIndexEntry> &entries)
+{
+    p->scanning.remove(path);
+    if(!p->refs.contains(path))
+    {
+        p->dirty.remove(path);
+        return;
+    }
+
+    if(p->dirty.remove(path))
+        directoryChanged(path);
+
+    const bool first = !p->dirs.contains(path);
+    QHash<QString,TelegramFileIndexEntry> &dir = p->dirs[path];
+    QHash<QString,TelegramFileIndexEntry> scanned;
+    Q_FOREACH(const TelegramFileIndexEntry &entry, entries)
+        scanned[entry.name] = entry;
+
+    if(first)
+    {
+        dir = scanned;
+        Q_EMIT directoryIndexed(path);
+        return;
+    }
+
+    const QStringList &names = dir.keys();
+    Q_FOREACH(const QString &name, names)
+        if(!scanned.contains(name))
+        {
+            dir.remove(name);
+            Q_EMIT fileRemoved(path, name);
+        }
+
+    Q_FOREACH(const TelegramFileIndexEntry &entry, entries)
+    {
+        QHash<QString,TelegramFileIndexEntry>::iterator i = dir.find(entry.name);
+        if(i != dir.end() && i.value().size == entry.size && i.value().modified == entry.modified)
+            continue;
+
+        dir[entry.name] = entry;
+        Q_EMIT fileChanged(path, entry.name);
+    }
+}
+
+void TelegramFileIndex::fileScanned(const QString &path, const TelegramFileIndexEntry &entry)
+{
+    if(!p->dirs.contains(path))
+        return;
+
+    p->dirs[path][entry.name] = entry;
+    Q_EMIT fileChanged(path, entry.name);
+}
+
+void TelegramFileIndex::fileMissing(const QString &path, const QString &name)
+{
+    if(!p->dirs.contains(path) || !p->dirs[path].remove(name))
+        return;
+
+    Q_EMIT fileRemoved(path, name);
+}
+
+TelegramFileIndex::~TelegramFileIndex()
+{
+    p->thread->quit();
+    p->thread->wait();
+
+    p->core->deleteLater();
+    delete p;
+}
@@ -0,0 +1,45 @@
+#ifndef TELEGRAMFILEINDEX_H
+#define TELEGRAMFILEINDEX_H
+
+#include <QObject>
+#include <QStringList>
+
+#include "telegramfileindexcore.h"
+
+class TelegramFileIndexPrivate;
+/*! Keeps per-directory file listings up to date from a file system
+ *  watcher, so models don't have to stat the directory on every refresh.
+ *  Paths are absolute directory paths. !*/
+class TelegramFileIndex : public QObject
+{
+    Q_OBJECT
+public:
+    TelegramFileIndex(QObject *parent = 0);
+    ~TelegramFileIndex();
+
+    void watch(const QString &path);
+    void unwatch(const QString &path);
+
+    bool indexed(const QString &path) const;
+    QStringList files(const QString &path) const;
+    TelegramFileIndexEntry entry(const QString &path, const QString &name) const;
+
+public Q_SLOTS:
+    void updateFile(const QString &filePath);
+
+Q_SIGNALS:
+    void directoryIndexed(const QString &path);
+    void fileChanged(const QString &path, const QString &name);
+    void fileRemoved(const QString &path, const QString &name);
+
+private Q_SLOTS:
+    void directoryChanged(const QString &path);
+    void directoryScanned(const QString &path, const QList<TelegramFileIndexEntry> &entries);
+    void fileScanned(const QString &path, const TelegramFileIndexEntry &entry);
+    void fileMissing(const QString &path, const QString &name);
+
+private:
+    TelegramFileIndexPrivate *p;
+};
+
+#endif // TELEGRAMFILEINDEX_H
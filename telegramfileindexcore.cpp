@@ -0,0 +1,50 @@
+#include "telegramfileindexcore.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+
+TelegramFileIndexCore::TelegramFileIndexCore(QObject *parent) :
+    QObject(parent)
+{
+    qRegisterMetaType<TelegramFileIndexEntry>("TelegramFileIndexEntry");
+    qRegisterMetaType< QList<TelegramFileIndexEntry> >("QList<TelegramFileIndexEntry>");
+}
+
+/*! One pass over the directory; QDirIterator hands out the stat data it
+ *  already has, and mime types are guessed from the name only !*/
+void TelegramFileIndexCore::scanDirectory(const QString &path)
+{
+    QList<TelegramFileIndexEntry> entries;
+    QDirIterator i(path, QDir::Files);
+    while(i.hasNext())
+    {
+        i.next();
+        entries << entry(i.fileInfo());
+    }
+
+    Q_EMIT directoryScanned(path, entries);
+}
+
+void TelegramFileIndexCore::scanFile(const QString &path, const QString &name)
+{
+    const QFileInfo info(path + "/" + name);
+    if(info.exists())
+        Q_EMIT fileScanned(path, entry(info));
+    else
+        Q_EMIT fileMissing(path, name);
+}
+
+TelegramFileIndexEntry TelegramFileIndexCore::entry(const QFileInfo &info) const
+{
+    TelegramFileIndexEntry result;
+    result.name = info.fileName();
+    result.size = info.size();
+    result.modified = info.lastModified();
+    result.mimeType = mime_db.mimeTypeForFile(info, QMimeDatabase::MatchExtension).name();
+    return result;
+}
+
+TelegramFileIndexCore::~TelegramFileIndexCore()
+{
+}
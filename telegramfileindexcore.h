@@ -0,0 +1,48 @@
+#ifndef TELEGRAMFILEINDEXCORE_H
+#define TELEGRAMFILEINDEXCORE_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QList>
+#include <QMetaType>
+#include <QMimeDatabase>
+
+class TelegramFileIndexEntry
+{
+public:
+    TelegramFileIndexEntry(): size(0) {}
+
+    QString name;
+    qint64 size;
+    QDateTime modified;
+    QString mimeType;
+};
+
+Q_DECLARE_METATYPE(TelegramFileIndexEntry)
+Q_DECLARE_METATYPE(QList<TelegramFileIndexEntry>)
+
+class TelegramFileIndexCore : public QObject
+{
+    Q_OBJECT
+public:
+    TelegramFileIndexCore(QObject *parent = 0);
+    ~TelegramFileIndexCore();
+
+public Q_SLOTS:
+    void scanDirectory(const QString &path);
+    void scanFile(const QString &path, const QString &name);
+
+Q_SIGNALS:
+    void directoryScanned(const QString &path, const QList<TelegramFileIndexEntry> &entries);
+    void fileScanned(const QString &path, const TelegramFileIndexEntry &entry);
+    void fileMissing(const QString &path, const QString &name);
+
+private:
+    TelegramFileIndexEntry entry(const QFileInfo &info) const;
+
+private:
+    QMimeDatabase mime_db;
+};
+
+#endif // TELEGRAMFILEINDEXCORE_H
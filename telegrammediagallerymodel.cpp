@@ -0,0 +1,446 @@
+#define LOAD_STEP_COUNT 50
+
+#include "telegrammediagallerymodel.h"
+#include "telegramqml.h"
+#include "database.h"
+#include "objects/types.h"
+
+#include <QPointer>
+#include <QTimer>
+
+class TelegramMediaGalleryModelPrivate
+{
+public:
+    QPointer<TelegramQml> telegram;
+    QPointer<DialogObject> dialog;
+    int mediaType;
+    int stepCount;
+
+    QList<qint64> messages;
+    QHash<qint32, int> counts;
+
+    /*! maxId of the page being read, -1 when idle !*/
+    qint64 pending;
+    QTimer *countsTimer;
+    bool initializing;
+    bool complete;
+};
+
+static QList<qint32> galleryClassTypes()
+{
+    return QList<qint32>() << static_cast<qint32>(MessageMedia::typeMessageMediaPhoto)
+                           << static_cast<qint32>(MessageMedia::typeMessageMediaVideo)
+                           << static_cast<qint32>(MessageMedia::typeMessageMediaDocument)
+                           << static_cast<qint32>(MessageMedia::typeMessageMediaAudio);
+}
+
+TelegramMediaGalleryModel::TelegramMediaGalleryModel(QObject *parent) :
+    TgAbstractListModel(parent)
+{
+    p = new TelegramMediaGalleryModelPrivate;
+    p->mediaType = AllMedia;
+    p->stepCount = LOAD_STEP_COUNT;
+    p->pending = -1;
+    p->initializing = false;
+    p->complete = false;
+
+    p->countsTimer = new QTimer(this);
+    p->countsTimer->setSingleShot(true);
+    p->countsTimer->setInterval(500);
+
+    connect(p->countsTimer, SIGNAL(timeout()), SLOT(refreshCounts()));
+}
+
+TelegramQml *TelegramMediaGalleryModel::telegram() const
+{
+    return p->telegram;
+}
+
+void TelegramMediaGalleryModel::setTelegram(TelegramQml *tg)
+{
+    if(p->telegram == tg)
+        return;
+
+    clear();
+    if(p->telegram)
+    {
+        disconnect(p->telegram->database(), 0, this, 0);
+        disconnect(p->telegram, SIGNAL(messageInserted(qint64,qint64)), this, SLOT(messageInserted(qint64,qint64)));
+    }
+
+    p->telegram = tg;
+    if(p->telegram)
+    {
+        connect(p->telegram->database(), SIGNAL(mediaFounded(Peer,QList<qint32>,qint64,QList<qint32>)),
+                SLOT(mediaFounded(Peer,QList<qint32>,qint64,QList<qint32>)));
+        connect(p->telegram->database(), SIGNAL(mediaCountsFounded(Peer,QList<qint32>,QList<qint32>)),
+                SLOT(mediaCountsFounded(Peer,QList<qint32>,QList<qint32>)));
+        connect(p->telegram, SIGNAL(messageInserted(qint64,qint64)), SLOT(messageInserted(qint64,qint64)));
+    }
+
+    Q_EMIT telegramChanged();
+    refresh();
+}
+
+DialogObject *TelegramMediaGalleryModel::dialog() const
+{
+    return p->dialog;
+}
+
+void TelegramMediaGalleryModel::setDialog(DialogObject *dlg)
+{
+    if(p->dialog == dlg)
+        return;
+
+    p->dialog = dlg;
+    Q_EMIT dialogChanged();
+
+    refresh();
+}
+
+int TelegramMediaGalleryModel::mediaType() const
+{
+    return p->mediaType;
+}
+
+void TelegramMediaGalleryModel::setMediaType(int type)
+{
+    if(p->mediaType == type)
+        return;
+
+    p->mediaType = type;
+    Q_EMIT mediaTypeChanged();
+
+    refresh();
+}
+
+int TelegramMediaGalleryModel::stepCount() const
+{
+    return p->stepCount;
+}
+
+void TelegramMediaGalleryModel::setStepCount(int step)
+{
+    if(p->stepCount == step)
+        return;
+
+    p->stepCount = qMax(1, step);
+    Q_EMIT stepCountChanged();
+}
+
+qint64 TelegramMediaGalleryModel::id(const QModelIndex &index) const
+{
+    return p->messages.at(index.row());
+}
+
+int TelegramMediaGalleryModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return p->messages.count();
+}
+
+QVariant TelegramMediaGalleryModel::data(const QModelIndex &index, int role) const
+{
+    QVariant res;
+    if(!p->telegram)
+        return res;
+
+    MessageObject *msg = p->telegram->message(id(index));
+    MessageMediaObject *media = msg->media();
+    switch(role)
+    {
+    case ItemRole:
+        res = QVariant::fromValue<MessageObject*>(msg);
+        break;
+
+    case MediaTypeRole:
+        res = media->classType();
+        break;
+
+    case DateRole:
+        res = msg->date();
+        break;
+
+    case FromIdRole:
+        res = msg->fromId();
+        break;
+
+    case ThumbnailRole:
+        switch(media->classType())
+        {
+        case MessageMedia::typeMessageMediaPhoto:
+            res = QVariant::fromValue<FileLocationObject*>(p->telegram->locationOfThumbPhoto(media->photo()));
+            break;
+        case MessageMedia::typeMessageMediaVideo:
+            res = QVariant::fromValue<FileLocationObject*>(media->video()->thumb()->location());
+            break;
+        case MessageMedia::typeMessageMediaDocument:
+            res = QVariant::fromValue<FileLocationObject*>(media->document()->thumb()->location());
+            break;
+        }
+        break;
+    }
+
+    return res;
+}
+
+QHash<qint32, QByteArray> TelegramMediaGalleryModel::roleNames() const
+{
+    static QHash<qint32, QByteArray> *res = 0;
+    if( res )
+        return *res;
+
+    res = new QHash<qint32, QByteArray>();
+    res->insert( ItemRole, "item");
+    res->insert( MediaTypeRole, "mediaType");
+    res->insert( DateRole, "date");
+    res->insert( FromIdRole, "fromId");
+    res->insert( ThumbnailRole, "thumbnail");
+    return *res;
+}
+
+int TelegramMediaGalleryModel::count() const
+{
+    return p->messages.count();
+}
+
+bool TelegramMediaGalleryModel::initializing() const
+{
+    return p->initializing;
+}
+
+bool TelegramMediaGalleryModel::complete() const
+{
+    return p->complete;
+}
+
+int TelegramMediaGalleryModel::photoCount() const
+{
+    return countOf(PhotoMedia);
+}
+
+int TelegramMediaGalleryModel::videoCount() const
+{
+    return countOf(VideoMedia);
+}
+
+int TelegramMediaGalleryModel::documentCount() const
+{
+    return countOf(DocumentMedia);
+}
+
+int TelegramMediaGalleryModel::audioCount() const
+{
+    return countOf(AudioMedia);
+}
+
+int TelegramMediaGalleryModel::countOf(int mediaType) const
+{
+    const QList<qint32> &types = galleryClassTypes();
+    if(mediaType == AllMedia)
+    {
+        int result = 0;
+        Q_FOREACH(qint32 type, types)
+            result += p->counts.value(type);
+        return result;
+    }
+
+    if(mediaType < PhotoMedia || mediaType > AudioMedia)
+        return 0;
+
+    return p->counts.value(types.at(mediaType-PhotoMedia));
+}
+
+void TelegramMediaGalleryModel::refresh()
+{
+    clear();
+    if(!p->telegram || !p->dialog)
+        return;
+    if(p->dialog == p->telegram->nullDialog())
+        return;
+    if(!p->dialog->peer()->chatId() && !p->dialog->peer()->userId())
+        return;
+
+    p->pending = 0;
+    p->initializing = true;
+    Q_EMIT initializingChanged();
+
+    p->telegram->database()->readMediaCounts(peer(), galleryClassTypes());
+    p->telegram->database()->readMedia(peer(), classTypes(), 0, p->stepCount);
+}
+
+void TelegramMediaGalleryModel::loadMore()
+{
+    if(!p->telegram || !p->dialog)
+        return;
+    if(p->complete || p->pending != -1 || p->messages.isEmpty())
+        return;
+
+    p->pending = p->messages.last();
+    p->telegram->database()->readMedia(peer(), classTypes(), p->pending, p->stepCount);
+}
+
+void TelegramMediaGalleryModel::mediaFounded(const Peer &peer, const QList<qint32> &mediaTypes, qint64 maxId, const QList<qint32> &messages)
+{
+    if(p->pending != maxId || !isPeer(peer) || mediaTypes != classTypes())
+        return;
+
+    /*! Live messages may already be in the list; pages only go down !*/
+    QList<qint64> page;
+    Q_FOREACH(qint32 msgId, messages)
+        if(p->messages.isEmpty() || msgId < p->messages.last())
+            page << msgId;
+
+    if(!page.isEmpty())
+    {
+        beginInsertRows(QModelIndex(), p->messages.count(), p->messages.count()+page.count()-1);
+        Q_FOREACH(qint64 msgId, page)
+        {
+            p->telegram->pinMessage(msgId);
+            p->messages << msgId;
+        }
+        endInsertRows();
+        Q_EMIT countChanged();
+    }
+
+    p->pending = -1;
+    if(messages.count() < p->stepCount)
+    {
+        p->complete = true;
+        Q_EMIT completeChanged();
+    }
+
+    if(p->initializing)
+    {
+        p->initializing = false;
+        Q_EMIT initializingChanged();
+    }
+}
+
+void TelegramMediaGalleryModel::mediaCountsFounded(const Peer &peer, const QList<qint32> &mediaTypes, const QList<qint32> &counts)
+{
+    if(!isPeer(peer))
+        return;
+
+    for(int i=0; i<mediaTypes.count() && i<counts.count(); i++)
+        p->counts[mediaTypes.at(i)] = counts.at(i);
+
+    Q_EMIT countsChanged();
+}
+
+void TelegramMediaGalleryModel::refreshCounts()
+{
+    if(!p->telegram || !p->dialog)
+        return;
+
+    p->telegram->database()->readMediaCounts(peer(), galleryClassTypes());
+}
+
+void TelegramMediaGalleryModel::messageInserted(qint64 msgId, qint64 dId)
+{
+    if(!p->dialog || dId != dialogId())
+        return;
+
+    const qint32 type = static_cast<qint32>(p->telegram->message(msgId)->media()->classType());
+    if(!galleryClassTypes().contains(type))
+        return;
+
+    /*! Inserted messages may be history the counts already include, so
+     *  they're read again once the writes queued behind this one are done !*/
+    if(!p->countsTimer->isActive())
+        p->countsTimer->start();
+
+    if(!classTypes().contains(type) || p->messages.contains(msgId))
+        return;
+    if(!p->complete && (p->messages.isEmpty() || msgId < p->messages.last()))
+        return;
+
+    QList<qint64>::iterator i = qUpperBound(p->messages.begin(), p->messages.end(), msgId, qGreater<qint64>());
+    const int row = i - p->messages.begin();
+
+    beginInsertRows(QModelIndex(), row, row);
+    p->telegram->pinMessage(msgId);
+    p->messages.insert(row, msgId);
+    endInsertRows();
+
+    Q_EMIT countChanged();
+}
+
+Peer TelegramMediaGalleryModel::peer() const
+{
+    if(p->dialog->encrypted())
+    {
+        Peer peer(Peer::typePeerChat);
+        peer.setChatId(p->dialog->peer()->userId());
+        return peer;
+    }
+
+    Peer peer( static_cast<Peer::PeerType>(p->dialog->peer()->classType()) );
+    peer.setChatId(p->dialog->peer()->chatId());
+    peer.setUserId(p->dialog->peer()->userId());
+    return peer;
+}
+
+qint64 TelegramMediaGalleryModel::dialogId() const
+{
+    return p->dialog->peer()->classType()==Peer::typePeerChat? p->dialog->peer()->chatId() : p->dialog->peer()->userId();
+}
+
+QList<qint32> TelegramMediaGalleryModel::classTypes() const
+{
+    const QList<qint32> &types = galleryClassTypes();
+    if(p->mediaType < PhotoMedia || p->mediaType > AudioMedia)
+        return types;
+
+    return QList<qint32>() << types.at(p->mediaType-PhotoMedia);
+}
+
+bool TelegramMediaGalleryModel::isPeer(const Peer &peer) const
+{
+    if(!p->dialog)
+        return false;
+
+    const Peer &current = TelegramMediaGalleryModel::peer();
+    return peer.classType() == current.classType() && peer.chatId() == current.chatId() &&
+           peer.userId() == current.userId();
+}
+
+void TelegramMediaGalleryModel::clear()
+{
+    const bool hadCounts = !p->counts.isEmpty();
+    const bool wasComplete = p->complete;
+    p->counts.clear();
+    p->countsTimer->stop();
+    p->pending = -1;
+    p->complete = false;
+
+    if(!p->messages.isEmpty())
+    {
+        beginResetModel();
+        if(p->telegram)
+            Q_FOREACH(qint64 msgId, p->messages)
+                p->telegram->unpinMessage(msgId);
+        p->messages.clear();
+        endResetModel();
+        Q_EMIT countChanged();
+    }
+
+    if(hadCounts)
+        Q_EMIT countsChanged();
+    if(wasComplete)
+        Q_EMIT completeChanged();
+    if(p->initializing)
+    {
+        p->initializing = false;
+        Q_EMIT initializingChanged();
+    }
+}
+
+TelegramMediaGalleryModel::~TelegramMediaGalleryModel()
+{
+    if(p->telegram)
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->unpinMessage(msgId);
+
+    delete p;
+}
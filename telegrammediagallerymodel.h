@@ -0,0 +1,112 @@
+#ifndef TELEGRAMMEDIAGALLERYMODEL_H
+#define TELEGRAMMEDIAGALLERYMODEL_H
+
+#include "telegramqml_global.h"
+#include "tgabstractlistmodel.h"
+
+class TelegramQml;
+class Peer;
+class DialogObject;
+class TelegramMediaGalleryModelPrivate;
+/*! Photos, videos, documents and audios of a dialog, newest first. Pages
+ *  are read from the database media index, so media that was never
+ *  downloaded is listed too. !*/
+class TELEGRAMQMLSHARED_EXPORT TelegramMediaGalleryModel : public TgAbstractListModel
+{
+    Q_OBJECT
+    Q_ENUMS(MediaRoles)
+    Q_ENUMS(MediaTypes)
+
+    Q_PROPERTY(TelegramQml* telegram READ telegram WRITE setTelegram NOTIFY telegramChanged)
+    Q_PROPERTY(DialogObject* dialog READ dialog WRITE setDialog NOTIFY dialogChanged)
+    Q_PROPERTY(int mediaType READ mediaType WRITE setMediaType NOTIFY mediaTypeChanged)
+    Q_PROPERTY(int stepCount READ stepCount WRITE setStepCount NOTIFY stepCountChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool initializing READ initializing NOTIFY initializingChanged)
+    Q_PROPERTY(bool complete READ complete NOTIFY completeChanged)
+    Q_PROPERTY(int photoCount READ photoCount NOTIFY countsChanged)
+    Q_PROPERTY(int videoCount READ videoCount NOTIFY countsChanged)
+    Q_PROPERTY(int documentCount READ documentCount NOTIFY countsChanged)
+    Q_PROPERTY(int audioCount READ audioCount NOTIFY countsChanged)
+
+public:
+    enum MediaRoles {
+        ItemRole = Qt::UserRole,
+        MediaTypeRole,
+        DateRole,
+        FromIdRole,
+        ThumbnailRole
+    };
+
+    enum MediaTypes {
+        AllMedia = 0,
+        PhotoMedia,
+        VideoMedia,
+        DocumentMedia,
+        AudioMedia
+    };
+
+    TelegramMediaGalleryModel(QObject *parent = 0);
+    ~TelegramMediaGalleryModel();
+
+    TelegramQml *telegram() const;
+    void setTelegram(TelegramQml *tg);
+
+    DialogObject *dialog() const;
+    void setDialog(DialogObject *dlg);
+
+    int mediaType() const;
+    void setMediaType(int type);
+
+    int stepCount() const;
+    void setStepCount(int step);
+
+    qint64 id( const QModelIndex &index ) const;
+    int rowCount(const QModelIndex & parent = QModelIndex()) const;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+    QHash<qint32,QByteArray> roleNames() const;
+
+    int count() const;
+    bool initializing() const;
+    bool complete() const;
+
+    int photoCount() const;
+    int videoCount() const;
+    int documentCount() const;
+    int audioCount() const;
+    Q_INVOKABLE int countOf(int mediaType) const;
+
+public Q_SLOTS:
+    void refresh();
+    void loadMore();
+
+Q_SIGNALS:
+    void telegramChanged();
+    void dialogChanged();
+    void mediaTypeChanged();
+    void stepCountChanged();
+    void countChanged();
+    void initializingChanged();
+    void completeChanged();
+    void countsChanged();
+
+private Q_SLOTS:
+    void mediaFounded(const Peer &peer, const QList<qint32> &mediaTypes, qint64 maxId, const QList<qint32> &messages);
+    void mediaCountsFounded(const Peer &peer, const QList<qint32> &mediaTypes, const QList<qint32> &counts);
+    void messageInserted(qint64 msgId, qint64 dId);
+    void refreshCounts();
+
+private:
+    Peer peer() const;
+    qint64 dialogId() const;
+    QList<qint32> classTypes() const;
+    bool isPeer(const Peer &peer) const;
+    void clear();
+
+private:
+    TelegramMediaGalleryModelPrivate *p;
+};
+
+#endif // TELEGRAMMEDIAGALLERYMODEL_H
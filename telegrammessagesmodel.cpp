@@ -17,6 +17,8 @@
 */
 
 #define LOAD_STEP_COUNT 50
+#define WINDOW_STEP_LIMIT 4
+#define REPLY_PREVIEW_LENGTH 100
 
 #include "telegrammessagesmodel.h"
 #include "telegramqml.h"
@@ -26,7 +28,24 @@
 
 #include <telegram.h>
 #include <QPointer>
+#include <QDateTime>
+#include <QVector>
 
+/*! Flat presentation values of a row, computed once and kept until the
+ *  message changes so delegates don't walk the object tree !*/
+class TelegramMessagesModelRow
+{
+public:
+    QString text;
+    qint32 date;
+    qint32 fromId;
+    QString fromName;
+    bool out;
+    quint32 mediaType;
+    QString daySection;
+    qint64 replyToId;
+    QString replyPreview;
+};
 
 class TelegramMessagesModelPrivate
 {
@@ -34,16 +53,22 @@ public:
     QPointer<TelegramQml> telegram;
     bool initializing;
     bool refreshing;
-    bool refreshing_cache;
     int maxId;
     int stepCount;
 
     QList<qint64> messages;
+    QHash<qint64, TelegramMessagesModelRow> rows;
     QPointer<DialogObject> dialog;
 
     int load_count;
     int load_limit;
-    int refresh_timer;
+
+    /*! Windowed mode: rows are window_newer messages above window_anchor,
+     *  the anchor itself and window_older messages below it. !*/
+    int anchorId;
+    qint64 window_anchor;
+    int window_newer;
+    int window_older;
 
     int unreadCount;
 };
@@ -55,12 +80,14 @@ TelegramMessagesModel::TelegramMessagesModel(QObject *parent) :
     p->telegram = 0;
     p->initializing = false;
     p->refreshing = false;
-    p->refreshing_cache = false;
     p->load_count = 0;
     p->load_limit = 0;
-    p->refresh_timer = 0;
     p->maxId = 0;
     p->stepCount = LOAD_STEP_COUNT;
+    p->anchorId = 0;
+    p->window_anchor = 0;
+    p->window_newer = 0;
+    p->window_older = 0;
     p->unreadCount = 0;
 }
 
@@ -76,18 +103,28 @@ void TelegramMessagesModel::setTelegram(TelegramQml *tgo)
         return;
     if(p->telegram)
     {
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->unpinMessage(msgId);
+
         p->telegram->unregisterMessagesModel(this);
         disconnect(p->telegram, SIGNAL(messagesChanged(bool)), this, SLOT(messagesChanged(bool)));
+        disconnect(p->telegram, SIGNAL(userRenamed(qint64)), this, SLOT(userRenamed(qint64)));
         disconnect(p->telegram, SIGNAL(authLoggedInChanged()), this, SLOT(init()));
         disconnect(p->telegram, SIGNAL(connectedChanged()), this, SLOT(init()));
         disconnect(p->telegram, SIGNAL(connectedChanged()), this, SLOT(setReaded()));
     }
 
     p->telegram = tg;
+    p->rows.clear();
     if( p->telegram )
     {
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->pinMessage(msgId);
+
         p->telegram->registerMessagesModel(this);
+        p->telegram->setMessagesModelDialog(this, dialogId());
         connect(p->telegram, SIGNAL(messagesChanged(bool)), this, SLOT(messagesChanged(bool)));
+        connect(p->telegram, SIGNAL(userRenamed(qint64)), this, SLOT(userRenamed(qint64)));
         connect(p->telegram, SIGNAL(authLoggedInChanged()), this, SLOT(init()), Qt::QueuedConnection);
         connect(p->telegram, SIGNAL(connectedChanged()), this, SLOT(init()), Qt::QueuedConnection);
         connect(p->telegram, SIGNAL(connectedChanged()), this, SLOT(setReaded()), Qt::QueuedConnection);
@@ -111,10 +148,16 @@ void TelegramMessagesModel::setDialog(DialogObject *dlg)
         return;
 
     p->dialog = dlg;
+    if(p->telegram)
+        p->telegram->setMessagesModelDialog(this, dialogId());
     Q_EMIT dialogChanged();
 
     beginResetModel();
+    if(p->telegram)
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->unpinMessage(msgId);
     p->messages.clear();
+    p->rows.clear();
     endResetModel();
 
     if( !p->dialog )
@@ -158,6 +201,22 @@ int TelegramMessagesModel::stepCount() const
     return p->stepCount;
 }
 
+void TelegramMessagesModel::setAnchorId(int id)
+{
+    if(p->anchorId == id)
+        return;
+
+    p->anchorId = id;
+    Q_EMIT anchorIdChanged();
+
+    init();
+}
+
+int TelegramMessagesModel::anchorId() const
+{
+    return p->anchorId;
+}
+
 int TelegramMessagesModel::indexOf(qint64 msgId) const
 {
     return p->messages.indexOf(msgId);
@@ -174,8 +233,17 @@ void TelegramMessagesModel::init()
 
     p->load_count = 0;
     p->load_limit = p->stepCount;
-    loadMore(true);
-    messagesChanged(true);
+    if(p->anchorId)
+    {
+        p->window_anchor = p->anchorId;
+        p->window_newer = p->stepCount;
+        p->window_older = p->stepCount;
+        requestWindowPage(p->anchorId+1, false);
+        requestWindowPage(p->anchorId, true);
+        messagesChanged_priv();
+    }
+    else
+        loadMore(true);
 
     if(p->dialog->peer()->userId() != NewsLetterDialog::cutegramId())
     {
@@ -226,6 +294,11 @@ void TelegramMessagesModel::loadMore(bool force)
         return;
     if(p->dialog == p->telegram->nullDialog())
         return;
+    if(p->anchorId)
+    {
+        moveWindow(false);
+        return;
+    }
 
     p->load_limit = p->load_count + p->stepCount;
 
@@ -239,6 +312,7 @@ void TelegramMessagesModel::loadMore(bool force)
         peer.setChatId(p->dialog->peer()->userId());
 
         p->telegram->database()->readMessages(peer, p->load_count, p->stepCount);
+        messagesChanged_priv();
         return;
     }
 
@@ -256,6 +330,97 @@ void TelegramMessagesModel::loadMore(bool force)
     p->telegram->database()->readMessages(TelegramMessagesModel::peer(), p->load_count, p->stepCount);
 
     Q_EMIT refreshingChanged();
+    messagesChanged_priv();
+}
+
+void TelegramMessagesModel::loadNewer()
+{
+    if( !p->telegram )
+        return;
+    if( !p->dialog )
+        return;
+    if( !p->anchorId )
+        return;
+
+    moveWindow(true);
+}
+
+void TelegramMessagesModel::moveWindow(bool newer)
+{
+    if(p->messages.isEmpty())
+        return;
+
+    const qint64 fromId = newer? p->messages.first() : p->messages.last();
+
+    const QList<qint64> &list = p->telegram->messages(dialogId());
+    const int idx = list.indexOf(p->window_anchor);
+    if(idx == -1)
+    {
+        if(newer)
+            p->window_newer += p->stepCount;
+        else
+            p->window_older += p->stepCount;
+    }
+    else
+    {
+        /*! Rows that aren't loaded don't count, only the page asked for
+         *  now is reserved beyond the loaded ones !*/
+        int first = qMax(0, idx - p->window_newer);
+        int last = qMin(list.count()-1, idx + p->window_older);
+        if(newer)
+            first -= p->stepCount;
+        else
+            last += p->stepCount;
+
+        /*! Keep the window bounded: drop rows from the far side and move the
+         *  anchor to the middle of what is left !*/
+        const int limit = p->stepCount*WINDOW_STEP_LIMIT;
+        if(last - first + 1 > limit)
+        {
+            if(newer)
+                last = first + limit - 1;
+            else
+                first = last - limit + 1;
+        }
+
+        const int anchor = qBound(qMax(0, first), (first+last)/2, qMin(list.count()-1, last));
+        p->window_anchor = list.at(anchor);
+        p->window_newer = anchor - first;
+        p->window_older = last - anchor;
+    }
+
+    requestWindowPage(fromId, newer);
+    messagesChanged_priv();
+}
+
+void TelegramMessagesModel::requestWindowPage(qint64 fromId, bool newer)
+{
+    if(p->dialog->encrypted())
+    {
+        Peer peer(Peer::typePeerChat);
+        peer.setChatId(p->dialog->peer()->userId());
+
+        p->telegram->database()->readMessagesFrom(peer, fromId, newer, p->stepCount);
+        return;
+    }
+
+    p->telegram->database()->readMessagesFrom(TelegramMessagesModel::peer(), fromId, newer, p->stepCount);
+
+    Telegram *tgObject = p->telegram->telegram();
+    if(!tgObject || !p->telegram->connected())
+        return;
+    if(p->dialog->peer()->userId() == NewsLetterDialog::cutegramId())
+        return;
+
+    /*! A negative offset makes maxId the lower bound of the page !*/
+    const InputPeer & peer = p->telegram->getInputPeer(peerId());
+    if(newer)
+        tgObject->messagesGetHistory(peer, -p->stepCount, fromId, p->stepCount);
+    else
+        tgObject->messagesGetHistory(peer, 0, fromId, p->stepCount);
+
+    p->refreshing = true;
+    Q_EMIT refreshingChanged();
 }
 
 void TelegramMessagesModel::sendMessage(const QString &msg, int inReplyTo)
@@ -325,11 +490,128 @@ QVariant TelegramMessagesModel::data(const QModelIndex &index, int role) const
     case UnreadedRole:
         res = index.row()<p->unreadCount;
         break;
+
+    case TextRole:
+        res = cachedRow(key).text;
+        break;
+
+    case DateRole:
+        res = cachedRow(key).date;
+        break;
+
+    case FromIdRole:
+        res = cachedRow(key).fromId;
+        break;
+
+    case FromNameRole:
+        res = cachedRow(key).fromName;
+        break;
+
+    case OutRole:
+        res = cachedRow(key).out;
+        break;
+
+    case MediaTypeRole:
+        res = cachedRow(key).mediaType;
+        break;
+
+    case DaySectionRole:
+        res = cachedRow(key).daySection;
+        break;
+
+    case SameSenderRole:
+    {
+        const int row = index.row();
+        if(row+1 >= p->messages.count())
+        {
+            res = false;
+            break;
+        }
+
+        const TelegramMessagesModelRow current = cachedRow(key);
+        const TelegramMessagesModelRow &previous = cachedRow(p->messages.at(row+1));
+        res = current.fromId == previous.fromId && current.daySection == previous.daySection;
+    }
+        break;
+
+    case ReplyPreviewRole:
+        res = cachedRow(key).replyPreview;
+        break;
     }
 
     return res;
 }
 
+const TelegramMessagesModelRow &TelegramMessagesModel::cachedRow(qint64 msgId) const
+{
+    QHash<qint64, TelegramMessagesModelRow>::iterator i = p->rows.find(msgId);
+    if(i != p->rows.end())
+        return i.value();
+
+    MessageObject *msg = p->telegram->message(msgId);
+
+    TelegramMessagesModelRow row;
+    row.text = msg->message();
+    row.date = msg->date();
+    row.fromId = msg->fromId();
+    row.fromName = p->telegram->userDisplayName(msg->fromId());
+    row.out = msg->out();
+    row.mediaType = msg->media()->classType();
+    row.daySection = QDateTime::fromTime_t(msg->date()).date().toString(Qt::ISODate);
+    row.replyToId = msg->replyToMsgId();
+    if(row.replyToId)
+        row.replyPreview = p->telegram->message(msg->replyToMsgId())->message().left(REPLY_PREVIEW_LENGTH);
+
+    return p->rows.insert(msgId, row).value();
+}
+
+/*! Cached rows replying to msgId show a preview of its text !*/
+void TelegramMessagesModel::refreshReplies(qint64 msgId)
+{
+    for(int i=0; i<p->messages.count(); i++)
+    {
+        QHash<qint64, TelegramMessagesModelRow>::iterator r = p->rows.find(p->messages.at(i));
+        if(r == p->rows.end() || r.value().replyToId != msgId)
+            continue;
+
+        const QString &preview = p->telegram->message(msgId)->message().left(REPLY_PREVIEW_LENGTH);
+        if(r.value().replyPreview == preview)
+            continue;
+
+        r.value().replyPreview = preview;
+        const QModelIndex &idx = index(i);
+        Q_EMIT dataChanged(idx, idx, QVector<int>() << ReplyPreviewRole);
+    }
+}
+
+void TelegramMessagesModel::userRenamed(qint64 userId)
+{
+    if(!p->telegram)
+        return;
+
+    const QString &name = p->telegram->userDisplayName(userId);
+    for(int i=0; i<p->messages.count(); i++)
+    {
+        QHash<qint64, TelegramMessagesModelRow>::iterator r = p->rows.find(p->messages.at(i));
+        if(r == p->rows.end() || r.value().fromId != userId || r.value().fromName == name)
+            continue;
+
+        r.value().fromName = name;
+        const QModelIndex &idx = index(i);
+        Q_EMIT dataChanged(idx, idx, QVector<int>() << FromNameRole);
+    }
+}
+
+/*! The "same sender" role of a row depends on the row below it !*/
+void TelegramMessagesModel::refreshSameSender(int row)
+{
+    if(row < 0 || row >= p->messages.count())
+        return;
+
+    const QModelIndex &idx = index(row);
+    Q_EMIT dataChanged(idx, idx, QVector<int>() << SameSenderRole);
+}
+
 QHash<qint32, QByteArray> TelegramMessagesModel::roleNames() const
 {
     static QHash<qint32, QByteArray> *res = 0;
@@ -339,6 +621,15 @@ QHash<qint32, QByteArray> TelegramMessagesModel::roleNames() const
     res = new QHash<qint32, QByteArray>();
     res->insert( ItemRole, "item");
     res->insert( UnreadedRole, "unreaded");
+    res->insert( TextRole, "text");
+    res->insert( DateRole, "date");
+    res->insert( FromIdRole, "fromId");
+    res->insert( FromNameRole, "fromName");
+    res->insert( OutRole, "out");
+    res->insert( MediaTypeRole, "mediaType");
+    res->insert( DaySectionRole, "daySection");
+    res->insert( SameSenderRole, "sameSender");
+    res->insert( ReplyPreviewRole, "replyPreview");
     return *res;
 }
 
@@ -371,6 +662,25 @@ qint64 TelegramMessagesModel::peerId() const
         return p->dialog->peer()->userId();
 }
 
+QList<qint64> TelegramMessagesModel::windowMessages() const
+{
+    const QList<qint64> &list = p->telegram->messages(dialogId());
+    const int idx = list.indexOf(p->window_anchor);
+    if(idx == -1)
+        return QList<qint64>();
+
+    const int first = qMax(0, idx - p->window_newer);
+    return list.mid(first, idx + p->window_older + 1 - first);
+}
+
+qint64 TelegramMessagesModel::dialogId() const
+{
+    if(!p->dialog)
+        return 0;
+
+    return p->dialog->peer()->classType()==Peer::typePeerChat? p->dialog->peer()->chatId() : p->dialog->peer()->userId();
+}
+
 Peer TelegramMessagesModel::peer() const
 {
     Peer peer( static_cast<Peer::PeerType>(p->dialog->peer()->classType()) );
@@ -379,105 +689,228 @@ Peer TelegramMessagesModel::peer() const
     return peer;
 }
 
+/*! Rows are kept up to date by insertMessageRow and removeMessageRow,
+ *  here we only track the end of a network refresh. !*/
 void TelegramMessagesModel::messagesChanged(bool cachedData)
 {
-    if(!cachedData && p->refreshing)
-    {
-        p->refreshing = false;
-        Q_EMIT refreshingChanged();
-    }
-
-    if(p->refresh_timer)
-        killTimer(p->refresh_timer);
+    if(cachedData || !p->refreshing)
+        return;
 
-    p->refresh_timer = startTimer(100);
+    p->refreshing = false;
+    Q_EMIT refreshingChanged();
+    Q_EMIT focusToNewRequest(p->unreadCount);
 }
 
-void TelegramMessagesModel::messagesChanged_priv()
+void TelegramMessagesModel::insertMessageRow(qint64 msgId)
 {
-    if( !p->dialog )
+    if(!p->telegram || !p->dialog)
+        return;
+    if(p->anchorId)
+    {
+        messagesChanged_priv();
+        refreshReplies(msgId);
+        return;
+    }
+    if(p->maxId && msgId > p->maxId)
         return;
 
-    qint32 did = p->dialog->peer()->classType()==Peer::typePeerChat? p->dialog->peer()->chatId() : p->dialog->peer()->userId();
-    const QList<qint64> & messages = p->telegram->messages(did, p->maxId).mid(0,p->load_limit);
-
-    for( int i=0 ; i<p->messages.count() ; i++ )
+    int row = p->messages.count();
+    for(int low=0; low<row; )
     {
-        const qint64 msgId = p->messages.at(i);
-        if( messages.contains(msgId) )
-            continue;
+        const int mid = (low+row)/2;
+        if(p->telegram->messageLessThan(msgId, p->messages.at(mid)))
+            row = mid;
+        else
+            low = mid+1;
+    }
+
+    if(row >= p->load_limit)
+        return;
+
+    if(!p->refreshing && row<p->unreadCount)
+        p->unreadCount++;
+
+    p->telegram->pinMessage(msgId);
+
+    beginInsertRows(QModelIndex(), row, row);
+    p->messages.insert(row, msgId);
+    endInsertRows();
+    refreshSameSender(row-1);
 
-        beginRemoveRows(QModelIndex(), i, i);
-        p->messages.removeAt(i);
-        i--;
+    if(p->messages.count() > p->load_limit)
+    {
+        const int last = p->messages.count()-1;
+        beginRemoveRows(QModelIndex(), last, last);
+        const qint64 lastId = p->messages.takeLast();
+        p->rows.remove(lastId);
+        p->telegram->unpinMessage(lastId);
         endRemoveRows();
+        refreshSameSender(last-1);
     }
 
-    QList<qint64> temp_msgs = messages;
-    for( int i=0 ; i<temp_msgs.count() ; i++ )
-    {
-        const qint64 msgId = temp_msgs.at(i);
-        if( p->messages.contains(msgId) )
-            continue;
+    refreshReplies(msgId);
 
-        temp_msgs.removeAt(i);
-        i--;
-    }
-    while( p->messages != temp_msgs )
-        for( int i=0 ; i<p->messages.count() ; i++ )
-        {
-            const qint64 msgId = p->messages.at(i);
-            int nw = temp_msgs.indexOf(msgId);
-            if( i == nw )
-                continue;
-
-            beginMoveRows( QModelIndex(), i, i, QModelIndex(), nw>i?nw+1:nw );
-            p->messages.move( i, nw );
-            endMoveRows();
-        }
+    p->load_count = p->messages.count();
+    Q_EMIT messageAdded(msgId);
+    Q_EMIT countChanged();
+}
 
+void TelegramMessagesModel::removeMessageRow(qint64 msgId)
+{
+    const int row = p->messages.indexOf(msgId);
+    if(row == -1)
+        return;
 
-    for( int i=0 ; i<messages.count() ; i++ )
+    if(msgId == p->window_anchor && p->messages.count() > 1)
     {
-        const qint64 msgId = messages.at(i);
-        if( p->messages.contains(msgId) )
-            continue;
+        const int anchor = row+1 < p->messages.count()? row+1 : row-1;
+        p->window_anchor = p->messages.at(anchor);
+        p->window_newer = anchor<row? anchor : anchor-1;
+        p->window_older = p->messages.count() - 2 - p->window_newer;
+    }
 
-        if(!p->refreshing_cache && !p->refreshing && i<p->unreadCount)
-            p->unreadCount++;
+    beginRemoveRows(QModelIndex(), row, row);
+    p->messages.removeAt(row);
+    p->rows.remove(msgId);
+    endRemoveRows();
+    refreshSameSender(row-1);
 
-        beginInsertRows(QModelIndex(), i, i );
-        p->messages.insert( i, msgId );
-        endInsertRows();
+    if(p->telegram)
+        p->telegram->unpinMessage(msgId);
 
-        Q_EMIT messageAdded(msgId);
+    /*! Pull the next messages past the last row, so the removal doesn't
+     *  leave the model a row short of its limit !*/
+    if(p->telegram && p->dialog)
+    {
+        if(p->anchorId)
+            messagesChanged_priv();
+        else
+        {
+            const QList<qint64> &list = p->telegram->messages(dialogId(), p->maxId);
+            int next = p->messages.isEmpty()? 0 : list.indexOf(p->messages.last())+1;
+            if(next == 0 && !p->messages.isEmpty())
+                next = list.count();
+
+            while(p->messages.count() < p->load_limit && next < list.count())
+            {
+                const qint64 nextId = list.at(next++);
+                if(p->messages.contains(nextId))
+                    continue;
+
+                const int last = p->messages.count();
+                p->telegram->pinMessage(nextId);
+                beginInsertRows(QModelIndex(), last, last);
+                p->messages.append(nextId);
+                endInsertRows();
+                refreshSameSender(last-1);
+                Q_EMIT messageAdded(nextId);
+            }
+        }
     }
 
     p->load_count = p->messages.count();
     Q_EMIT countChanged();
+}
 
-    if(p->refreshing_cache && !p->refreshing)
-        Q_EMIT focusToNewRequest(p->unreadCount);
+void TelegramMessagesModel::updateMessageRow(qint64 msgId)
+{
+    if(p->telegram)
+        refreshReplies(msgId);
+    if(!p->rows.contains(msgId))
+        return;
 
-    p->refreshing_cache = p->refreshing;
+    const TelegramMessagesModelRow old = p->rows.take(msgId);
+    const int row = p->messages.indexOf(msgId);
+    if(row == -1 || !p->telegram)
+        return;
+
+    const TelegramMessagesModelRow &current = cachedRow(msgId);
+    QVector<int> roles;
+    if(old.text != current.text)
+        roles << TextRole;
+    if(old.date != current.date)
+        roles << DateRole;
+    if(old.fromId != current.fromId)
+        roles << FromIdRole;
+    if(old.fromName != current.fromName)
+        roles << FromNameRole;
+    if(old.out != current.out)
+        roles << OutRole;
+    if(old.mediaType != current.mediaType)
+        roles << MediaTypeRole;
+    if(old.daySection != current.daySection)
+        roles << DaySectionRole;
+    if(old.replyPreview != current.replyPreview)
+        roles << ReplyPreviewRole;
+
+    const bool senderChanged = roles.contains(FromIdRole) || roles.contains(DaySectionRole);
+    if(senderChanged)
+        roles << SameSenderRole;
+    if(roles.isEmpty())
+        return;
+
+    const QModelIndex &idx = index(row);
+    Q_EMIT dataChanged(idx, idx, roles);
+    if(senderChanged)
+        refreshSameSender(row-1);
 }
 
-void TelegramMessagesModel::timerEvent(QTimerEvent *e)
+void TelegramMessagesModel::messagesChanged_priv()
 {
-    if(e->timerId() == p->refresh_timer)
+    if( !p->dialog )
+        return;
+
+    qint32 did = p->dialog->peer()->classType()==Peer::typePeerChat? p->dialog->peer()->chatId() : p->dialog->peer()->userId();
+    const QList<qint64> & messages = p->anchorId? windowMessages() : p->telegram->messages(did, p->maxId).mid(0,p->load_limit);
+
+    /*! Remember the row below each row, only rows whose neighbour
+     *  changes need their "same sender" role refreshed !*/
+    QHash<qint64,qint64> below;
+    below.reserve(p->messages.count());
+    for(int i=0; i<p->messages.count(); i++)
+        below[p->messages.at(i)] = i+1<p->messages.count()? p->messages.at(i+1) : 0;
+
+    QList<qint64> removed;
+    QList<int> inserted;
+    syncList(p->messages, messages, &removed, &inserted);
+
+    Q_FOREACH(qint64 msgId, removed)
     {
-        killTimer(p->refresh_timer);
-        p->refresh_timer = 0;
-        messagesChanged_priv();
+        p->rows.remove(msgId);
+        p->telegram->unpinMessage(msgId);
+    }
+
+    Q_FOREACH(int row, inserted)
+    {
+        const qint64 msgId = p->messages.at(row);
+        p->telegram->pinMessage(msgId);
+        Q_EMIT messageAdded(msgId);
+    }
+
+    for(int i=0; i<p->messages.count(); i++)
+    {
+        QHash<qint64,qint64>::const_iterator j = below.constFind(p->messages.at(i));
+        if(j == below.constEnd())
+            continue;
+
+        const qint64 next = i+1<p->messages.count()? p->messages.at(i+1) : 0;
+        if(j.value() != next)
+            refreshSameSender(i);
     }
 
-    TgAbstractListModel::timerEvent(e);
+    p->load_count = p->messages.count();
+    Q_EMIT countChanged();
 }
 
 TelegramMessagesModel::~TelegramMessagesModel()
 {
     if(p->telegram)
+    {
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->unpinMessage(msgId);
+
         p->telegram->unregisterMessagesModel(this);
+    }
 
     delete p;
 }
@@ -27,6 +27,7 @@ class Peer;
 class InputPeer;
 class DialogObject;
 class TelegramMessagesModelPrivate;
+class TelegramMessagesModelRow;
 class TELEGRAMQMLSHARED_EXPORT TelegramMessagesModel : public TgAbstractListModel
 {
     Q_OBJECT
@@ -38,12 +39,22 @@ class TELEGRAMQMLSHARED_EXPORT TelegramMessagesModel : public TgAbstractListMode
     Q_PROPERTY(bool refreshing  READ refreshing  NOTIFY refreshingChanged)
     Q_PROPERTY(int maxId READ maxId WRITE setMaxId NOTIFY maxIdChanged)
     Q_PROPERTY(int stepCount READ stepCount WRITE setStepCount NOTIFY stepCountChanged)
+    Q_PROPERTY(int anchorId READ anchorId WRITE setAnchorId NOTIFY anchorIdChanged)
     Q_PROPERTY(bool hasNewMessage READ hasNewMessage NOTIFY hasNewMessageChanged)
 
 public:
     enum MessagesRoles {
         ItemRole = Qt::UserRole,
-        UnreadedRole
+        UnreadedRole,
+        TextRole,
+        DateRole,
+        FromIdRole,
+        FromNameRole,
+        OutRole,
+        MediaTypeRole,
+        DaySectionRole,
+        SameSenderRole,
+        ReplyPreviewRole
     };
 
     TelegramMessagesModel(QObject *parent = 0);
@@ -61,6 +72,9 @@ public:
     void setStepCount(int step);
     int stepCount() const;
 
+    void setAnchorId(int id);
+    int anchorId() const;
+
     Q_INVOKABLE int indexOf(qint64 msgId) const;
 
     qint64 id( const QModelIndex &index ) const;
@@ -78,9 +92,14 @@ public:
     qint64 peerId() const;
     Peer peer() const;
 
+    void insertMessageRow(qint64 msgId);
+    void removeMessageRow(qint64 msgId);
+    void updateMessageRow(qint64 msgId);
+
 public Q_SLOTS:
     void refresh();
     void loadMore(bool force = false);
+    void loadNewer();
     void sendMessage( const QString & msg, int inReplyTo = 0 );
     void setReaded();
     void clearNewMessageFlag();
@@ -93,6 +112,7 @@ Q_SIGNALS:
     void refreshingChanged();
     void maxIdChanged();
     void stepCountChanged();
+    void anchorIdChanged();
     void messageAdded(qint64 msgId);
     void hasNewMessageChanged();
     void focusToNewRequest(int unreads);
@@ -100,12 +120,18 @@ Q_SIGNALS:
 private Q_SLOTS:
     void messagesChanged(bool cachedData);
     void messagesChanged_priv();
+    void userRenamed(qint64 userId);
     void init();
 
-protected:
-    void timerEvent(QTimerEvent *e);
-
 private:
+    qint64 dialogId() const;
+    const TelegramMessagesModelRow &cachedRow(qint64 msgId) const;
+    void refreshSameSender(int row);
+    void refreshReplies(qint64 msgId);
+    QList<qint64> windowMessages() const;
+    void moveWindow(bool newer);
+    void requestWindowPage(qint64 fromId, bool newer);
+
     TelegramMessagesModelPrivate *p;
 };
 
@@ -24,6 +24,8 @@
 #include "telegrammessagesmodel.h"
 #include "telegramthumbnailer.h"
 #include "objects/types.h"
+#include "tqflathash.h"
+#include "telegramqml_macros.h"
 
 #include <secret/secretchat.h>
 #include <secret/decrypter.h>
@@ -46,6 +48,10 @@
 #include <QImageWriter>
 #include <QBuffer>
 #include <QTimer>
+#include <QLinkedList>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QCryptographicHash>
 #include <QAudioDecoder>
 #include <QMediaMetaData>
 
@@ -67,6 +73,65 @@ const int THUMB_SIZE = 128;
 
 
 TelegramQmlPrivate *telegramp_qml_tmp = 0;
+
+const int UPDATES_GAP_TIMEOUT = 1000;
+const int TYPING_WHEEL_TICK = 1000;
+const int TYPING_WHEEL_SLOTS = 7;
+const int DIFFERENCE_SLICE_TIME = 15;
+const int FETCH_BATCH_LIMIT = 100;
+const int DIALOGS_FIRST_PAGE_LIMIT = 20;
+const int CHAT_FULL_TTL = 3600;
+const int DIALOGS_PAGE_LIMIT = 100;
+const int DIALOGS_PAGE_DELAY = 500;
+const int FETCH_RETRY_TIMEOUT = 5000;
+const int FETCH_MAX_TRIES = 3;
+const int MESSAGES_STORE_LIMIT = 10000;
+
+class TelegramQmlUnreadState
+{
+public:
+    TelegramQmlUnreadState(): count(0), badges(false), muted(false), favorited(false){}
+    int count;
+    bool badges;
+    bool muted;
+    bool favorited;
+};
+
+class TelegramQmlUpdatesBlock
+{
+public:
+    TelegramQmlUpdatesBlock(): date(0), seqStart(0), seq(0){}
+    QList<Update> updates;
+    QList<User> users;
+    QList<Chat> chats;
+    qint32 date;
+    qint32 seqStart;
+    qint32 seq;
+};
+
+class TelegramQmlDifference
+{
+public:
+    TelegramQmlDifference(): intermediate(false), receivedMessageCount(0){}
+    QList<User> users;
+    QList<Chat> chats;
+    QList<Update> updates;
+    QList<Message> messages;
+    QList<SecretChatMessage> secretChatMessages;
+    UpdatesState state;
+    bool intermediate;
+    qint32 receivedMessageCount;
+};
+
+class TelegramQmlFetchQueue
+{
+public:
+    QList<qint32> database;
+    QList<qint32> network;
+    QHash<qint32,int> tries;
+    QHash<qint32,qint32> sources;
+};
+
 bool checkDialogLessThan( qint64 a, qint64 b );
 bool checkMessageLessThan( qint64 a, qint64 b );
 
@@ -97,11 +162,15 @@ public:
     bool online;
     bool invisible;
     int unreadCount;
+    int unreadMutedCount;
+    int unreadFavoritesCount;
     int autoRewakeInterval;
     qreal totalUploadedPercent;
 
     bool autoAcceptEncrypted;
     bool autoCleanUpMessages;
+    int messagesCacheLimit;
+    int messagesStoreLimit;
 
     bool authNeeded;
     bool authLoggedIn;
@@ -123,16 +192,23 @@ public:
     QString upload_photo_path;
 
     QSet<TelegramMessagesModel*> messagesModels;
+    QHash<qint64, QSet<TelegramMessagesModel*> > messagesModelsOfDialog;
+    QHash<TelegramMessagesModel*, qint64> messagesModelDialogs;
     QSet<TelegramSearchModel*> searchModels;
 
-    QHash<qint64,DialogObject*> dialogs;
-    QHash<qint64,MessageObject*> messages;
-    QHash<qint64,ChatObject*> chats;
-    QHash<qint64,UserObject*> users;
+    TqFlatHash<DialogObject*> dialogs;
+    QHash<qint64,Message> messages_store;
+    TqFlatHash<qint32> messages_dates; /*! Flat date projection of the store, for the sort comparators !*/
+    QSet<qint64> encrypted_messages;
+    QHash<qint64, QPair<QByteArray,QByteArray> > messages_media_keys;
+    TqFlatHash<MessageObject*> messages;
+    TqFlatHash<ChatObject*> chats;
+    TqFlatHash<UserObject*> users;
     QHash<QString,StickerPackObject*> stickerPacks;
     QHash<qint64,StickerSetObject*> stickerSets;
     QHash<qint64,DocumentObject*> documents;
     QHash<qint64,ChatFullObject*> chatfulls;
+    QHash<qint64,qint64> chatfulls_updated;
     QHash<qint64,ContactObject*> contacts;
     QHash<qint64,EncryptedMessageObject*> encmessages;
     QHash<qint64,EncryptedChatObject*> encchats;
@@ -141,36 +217,69 @@ public:
     QSet<qint64> stickers;
     QMap<qint64, QSet<qint64> > stickersMap;
     QSet<qint64> installedStickerSets;
+    QString stickersHash;
+    bool stickersLoaded;
+    bool stickersRequested;
     QHash<QString, qint64> stickerShortIds;
+    QHash<QString, QSet<qint64> > stickerEmoticons;
+
+    QCollator collator;
+    QHash<qint64, QCollatorSortKey> userSortKeys;
+    QHash<qint64, QString> userSearchKeys;
+    QHash<qint64, qint64> stickerDocumentSets;
 
     QMultiMap<QString, qint64> userNameIndexes;
+    QHash<qint64, QStringList> userNameKeys;
+    mutable QHash<qint64, QSet<qint64> > chatParticipantSets;
 
     QHash<qint64,DialogObject*> fakeDialogs;
 
     QList<qint64> dialogs_list;
+    QHash<qint64, TelegramQmlUnreadState> dialogs_unread;
     QHash<qint64, QList<qint64> > messages_list;
     QMap<qint64, WallPaperObject*> wallpapers_map;
 
     QHash<qint64,MessageObject*> pend_messages;
-    QHash<qint64,FileLocationObject*> downloads;
+    QHash<qint64, QPointer<FileLocationObject> > downloads;
     QHash<qint64,MessageObject*> uploads;
-    QHash<qint64,FileLocationObject*> accessHashes;
+    QHash<qint64, QPointer<FileLocationObject> > accessHashes;
+    QHash<QObject*, qint64> accessHashObjects;
     QHash<qint64,qint64> read_history_requests;
     QHash<qint64,qint64> delete_history_requests;
     QSet<qint64> deleteChatIds;
     QHash<qint64,qint64> blockRequests;
     QHash<qint64,qint64> unblockRequests;
-    QList<qint32> request_messages;
+    TelegramQmlFetchQueue fetch_messages;
+    TelegramQmlFetchQueue fetch_users;
+    TelegramQmlFetchQueue fetch_chats;
     QMultiHash<qint64, qint64> pending_replies;
     QHash<qint64, QString> pending_stickers_uninstall;
     QHash<qint64, QString> pending_stickers_install;
     QHash<qint64, DocumentObject*> pending_doc_stickers;
 
+    QHash<qint64,int> messages_pins;
+    QLinkedList<qint64> messages_lru;
+    QHash<qint64, QLinkedList<qint64>::iterator> messages_lru_index;
+    mutable QSet<qint64> messages_locked;
+
     QSet<QObject*> garbages;
 
-    QHash<int, QPair<qint64,qint64> > typing_timers;
+    QHash<qint64, QSet<qint64> > typing_users;
+    QHash<QPair<qint64,qint64>, int> typing_slots;
+    QVector< QSet< QPair<qint64,qint64> > > typing_wheel;
+    int typing_wheel_pos;
+    int typing_wheel_timer;
     int upd_dialogs_timer;
+    int dialogs_sync_timer;
+    qint64 dialogs_sync_request;
+    int dialogs_sync_offset;
+    int dialogs_sync_limit;
+    QSet<qint64> dialogs_sync_seen;
+    qint32 dialogs_sync_start;
+    qint32 dialogs_sync_total;
+    bool dialogs_sync_shifted;
     int update_contacts_timer;
+    QString contactsHash;
     int garbage_checker_timer;
 
     DialogObject *nullDialog;
@@ -196,11 +305,19 @@ public:
 
     QPointer<QObject> newsletter_dlg;
     QTimer *cleanUpTimer;
-    QTimer *messageRequester;
+    QTimer *fetchTimer;
+    QTimer *fetchRetryTimer;
 
     UpdatesState state;
+    QMap<qint32, Update> pending_updates;
+    QMap<qint32, TelegramQmlUpdatesBlock> pending_blocks;
+    TelegramQmlDifference difference;
+    QTimer *updatesGapTimer;
+    QTimer *differenceApplier;
+    qint64 difference_request;
 
     TelegramThumbnailer thumbnailer;
+    TelegramFileIndex fileIndex;
 
     QTimer *sleepTimer;
     QTimer *wakeTimer;
@@ -214,9 +331,23 @@ TelegramQml::TelegramQml(QObject *parent) :
     p->defaultHostDcId = 0;
     p->appId = 0;
     p->upd_dialogs_timer = 0;
+    p->dialogs_sync_timer = 0;
+    p->dialogs_sync_request = 0;
+    p->dialogs_sync_offset = 0;
+    p->dialogs_sync_limit = 0;
+    p->dialogs_sync_start = 0;
+    p->dialogs_sync_total = -1;
+    p->dialogs_sync_shifted = false;
+    p->stickersLoaded = false;
+    p->stickersRequested = false;
     p->update_contacts_timer = 0;
     p->garbage_checker_timer = 0;
+    p->typing_wheel.resize(TYPING_WHEEL_SLOTS);
+    p->typing_wheel_pos = 0;
+    p->typing_wheel_timer = 0;
     p->unreadCount = 0;
+    p->unreadMutedCount = 0;
+    p->unreadFavoritesCount = 0;
     p->autoRewakeInterval = 0;
     p->encrypter = 0;
     p->totalUploadedPercent = 0;
@@ -231,18 +362,39 @@ TelegramQml::TelegramQml(QObject *parent) :
     p->wakeTimer = 0;
     p->autoAcceptEncrypted = false;
     p->autoCleanUpMessages = false;
+    p->messagesCacheLimit = 200;
+    p->messagesStoreLimit = MESSAGES_STORE_LIMIT;
+    p->collator.setCaseSensitivity(Qt::CaseInsensitive);
+    p->collator.setNumericMode(true);
 
     p->cleanUpTimer = new QTimer(this);
     p->cleanUpTimer->setSingleShot(true);
     p->cleanUpTimer->setInterval(60000);
 
-    p->messageRequester = new QTimer(this);
-    p->messageRequester->setSingleShot(true);
-    p->messageRequester->setInterval(50);
+    p->fetchTimer = new QTimer(this);
+    p->fetchTimer->setSingleShot(true);
+    p->fetchTimer->setInterval(50);
+
+    p->fetchRetryTimer = new QTimer(this);
+    p->fetchRetryTimer->setSingleShot(true);
+    p->fetchRetryTimer->setInterval(FETCH_RETRY_TIMEOUT);
+
+    p->updatesGapTimer = new QTimer(this);
+    p->updatesGapTimer->setSingleShot(true);
+    p->updatesGapTimer->setInterval(UPDATES_GAP_TIMEOUT);
+
+    p->differenceApplier = new QTimer(this);
+    p->differenceApplier->setInterval(0);
+    p->difference_request = 0;
 
     p->userdata = new UserData(this);
     p->database = new Database(this);
 
+    connect(p->userdata, SIGNAL(muteChanged(int))       , SLOT(refreshDialogUnread(int)));
+    connect(p->userdata, SIGNAL(favoriteChanged(int))   , SLOT(refreshDialogUnread(int)));
+    connect(p->userdata, SIGNAL(notifyChanged(int,int)) , SLOT(refreshDialogUnread(int)));
+    connect(p->userdata, SIGNAL(phoneNumberChanged())   , SLOT(refreshUnreadCount())    );
+
     p->telegram = 0;
     p->tsettings = 0;
     p->authNeeded = false;
@@ -274,7 +426,10 @@ TelegramQml::TelegramQml(QObject *parent) :
     p->nullStickerPack = new StickerPackObject(StickerPack(), this);
 
     connect(p->cleanUpTimer    , SIGNAL(timeout()), SLOT(cleanUpMessages_prv())   );
-    connect(p->messageRequester, SIGNAL(timeout()), SLOT(requestReadMessage_prv()));
+    connect(p->fetchTimer, SIGNAL(timeout()), SLOT(fetchMissing_prv()));
+    connect(p->fetchRetryTimer, SIGNAL(timeout()), SLOT(fetchRetry_prv()));
+    connect(p->updatesGapTimer , SIGNAL(timeout()), SLOT(updatesGapTimeout())     );
+    connect(p->differenceApplier, SIGNAL(timeout()), SLOT(applyDifferenceSlice()) );
 }
 
 QString TelegramQml::phoneNumber() const
@@ -291,6 +446,11 @@ void TelegramQml::setPhoneNumber(const QString &phone)
     p->userdata->setPhoneNumber(phone);
     p->database->setPhoneNumber(phone);
 
+    /*! The cached sticker collection belongs to the old database !*/
+    p->stickersLoaded = false;
+    p->stickersRequested = false;
+    p->stickersHash.clear();
+
     try_init();
 
     Q_EMIT phoneNumberChanged();
@@ -303,8 +463,13 @@ void TelegramQml::setPhoneNumber(const QString &phone)
     connect(p->database, SIGNAL(dialogFounded(Dialog,bool)), SLOT(dbDialogFounded(Dialog,bool)));
     connect(p->database, SIGNAL(messageFounded(Message))   , SLOT(dbMessageFounded(Message))   );
     connect(p->database, SIGNAL(contactFounded(Contact))   , SLOT(dbContactFounded(Contact))   );
+    connect(p->database, SIGNAL(chatFullFounded(ChatFull,qint64)), SLOT(dbChatFullFounded(ChatFull,qint64)));
+    connect(p->database, SIGNAL(stickersFounded(MessagesAllStickers)), SLOT(dbStickersFounded(MessagesAllStickers)));
     connect(p->database, SIGNAL(mediaKeyFounded(qint64,QByteArray,QByteArray)),
             SLOT(dbMediaKeysFounded(qint64,QByteArray,QByteArray)) );
+    connect(p->database, SIGNAL(valueFounded(QString,QString)), SLOT(dbValueFounded(QString,QString)) );
+    connect(p->database, SIGNAL(missingFetched(QList<qint32>,QList<qint32>,QList<qint32>)),
+            SLOT(dbMissingFetched(QList<qint32>,QList<qint32>,QList<qint32>)) );
 }
 
 QString TelegramQml::downloadPath() const
@@ -359,6 +524,10 @@ void TelegramQml::setConfigPath(const QString &conf)
     p->database->setConfigPath(conf);
     p->userdata->setConfigPath(conf);
 
+    p->stickersLoaded = false;
+    p->stickersRequested = false;
+    p->stickersHash.clear();
+
     if( p->tempPath.isEmpty() )
         p->tempPath = conf;
     if( p->downloadPath.isEmpty() )
@@ -562,6 +731,79 @@ bool TelegramQml::autoCleanUpMessages() const
     return p->autoCleanUpMessages;
 }
 
+void TelegramQml::setMessagesCacheLimit(int limit)
+{
+    if(p->messagesCacheLimit == limit)
+        return;
+
+    p->messagesCacheLimit = limit;
+    if(p->autoCleanUpMessages && !p->cleanUpTimer->isActive())
+        p->cleanUpTimer->start();
+
+    Q_EMIT messagesCacheLimitChanged();
+}
+
+int TelegramQml::messagesCacheLimit() const
+{
+    return p->messagesCacheLimit;
+}
+
+void TelegramQml::setMessagesStoreLimit(int limit)
+{
+    if(p->messagesStoreLimit == limit)
+        return;
+
+    p->messagesStoreLimit = limit;
+    if(p->autoCleanUpMessages && messagesStoreFull() && !p->cleanUpTimer->isActive())
+        p->cleanUpTimer->start();
+
+    Q_EMIT messagesStoreLimitChanged();
+}
+
+int TelegramQml::messagesStoreLimit() const
+{
+    return p->messagesStoreLimit;
+}
+
+void TelegramQml::pinMessage(qint64 msgId)
+{
+    if(!msgId)
+        return;
+
+    int &pins = p->messages_pins[msgId];
+    pins++;
+    if(pins != 1)
+        return;
+
+    /*! Pinned messages are kept out of the lru list !*/
+    p->messages_locked.remove(msgId);
+    QHash<qint64, QLinkedList<qint64>::iterator>::iterator i = p->messages_lru_index.find(msgId);
+    if(i == p->messages_lru_index.end())
+        return;
+
+    p->messages_lru.erase(i.value());
+    p->messages_lru_index.erase(i);
+}
+
+void TelegramQml::unpinMessage(qint64 msgId)
+{
+    QHash<qint64,int>::iterator i = p->messages_pins.find(msgId);
+    if(i == p->messages_pins.end())
+        return;
+
+    i.value()--;
+    if(i.value() > 0)
+        return;
+
+    p->messages_pins.erase(i);
+    if(!p->messages.contains(msgId))
+        return;
+
+    touchMessage(msgId);
+    if(p->autoCleanUpMessages && messagesCacheFull() && !p->cleanUpTimer->isActive())
+        p->cleanUpTimer->start();
+}
+
 void TelegramQml::registerMessagesModel(TelegramMessagesModel *model)
 {
     p->messagesModels.insert(model);
@@ -570,10 +812,35 @@ void TelegramQml::registerMessagesModel(TelegramMessagesModel *model)
 
 void TelegramQml::unregisterMessagesModel(TelegramMessagesModel *model)
 {
+    setMessagesModelDialog(model, 0);
     p->messagesModels.remove(model);
     disconnect(model, SIGNAL(dialogChanged()), this, SLOT(cleanUpMessages()));
 }
 
+void TelegramQml::setMessagesModelDialog(TelegramMessagesModel *model, qint64 dId)
+{
+    const qint64 oldDId = p->messagesModelDialogs.take(model);
+    if(oldDId)
+    {
+        QSet<TelegramMessagesModel*> &models = p->messagesModelsOfDialog[oldDId];
+        models.remove(model);
+        if(models.isEmpty())
+            p->messagesModelsOfDialog.remove(oldDId);
+    }
+
+    if(!dId)
+        return;
+
+    p->messagesModelDialogs[model] = dId;
+    p->messagesModelsOfDialog[dId].insert(model);
+}
+
+bool TelegramQml::messageLessThan(qint64 a, qint64 b) const
+{
+    telegramp_qml_tmp = p;
+    return checkMessageLessThan(a, b);
+}
+
 void TelegramQml::registerSearchModel(TelegramSearchModel *model)
 {
     p->searchModels.insert(model);
@@ -693,6 +960,16 @@ int TelegramQml::unreadCount() const
     return p->unreadCount;
 }
 
+int TelegramQml::unreadMutedCount() const
+{
+    return p->unreadMutedCount;
+}
+
+int TelegramQml::unreadFavoritesCount() const
+{
+    return p->unreadFavoritesCount;
+}
+
 qreal TelegramQml::totalUploadedPercent() const
 {
     return p->totalUploadedPercent;
@@ -862,7 +1139,7 @@ DialogObject *TelegramQml::dialog(qint64 id) const
 
 MessageObject *TelegramQml::message(qint64 id) const
 {
-    MessageObject *res = p->messages.value(id);
+    MessageObject *res = materializeMessage(id);
     if( !res )
         res = p->nullMessage;
     return res;
@@ -884,15 +1161,71 @@ UserObject *TelegramQml::user(qint64 id) const
     return res;
 }
 
+/*! Locale aware sort key of the user's full name, kept until the user
+ *  is renamed. Keys of unknown users are not kept. !*/
+QCollatorSortKey TelegramQml::userSortKey(qint64 id) const
+{
+    QHash<qint64, QCollatorSortKey>::const_iterator i = p->userSortKeys.constFind(id);
+    if(i != p->userSortKeys.constEnd())
+        return i.value();
+
+    UserObject *obj = user(id);
+    const QCollatorSortKey &key = p->collator.sortKey((obj->firstName() + " " + obj->lastName()).trimmed());
+    if(obj != p->nullUser)
+        p->userSortKeys.insert(id, key);
+    return key;
+}
+
+/*! Full name shown for the user in rows and titles !*/
+QString TelegramQml::userDisplayName(qint64 id) const
+{
+    UserObject *obj = user(id);
+    return (obj->firstName() + " " + obj->lastName()).trimmed();
+}
+
+/*! normalizeName() of the user's full name, cached like the sort key !*/
+QString TelegramQml::userSearchKey(qint64 id) const
+{
+    QHash<qint64, QString>::const_iterator i = p->userSearchKeys.constFind(id);
+    if(i != p->userSearchKeys.constEnd())
+        return i.value();
+
+    UserObject *obj = user(id);
+    const QString &key = normalizeName(obj->firstName() + " " + obj->lastName());
+    if(obj != p->nullUser)
+        p->userSearchKeys.insert(id, key);
+    return key;
+}
+
+/*! Case folded, without accents and with single spaces; used to match
+ *  names typed in any form !*/
+QString TelegramQml::normalizeName(const QString &name)
+{
+    const QString &decomposed = name.normalized(QString::NormalizationForm_KD);
+    QString result;
+    result.reserve(decomposed.length());
+    Q_FOREACH(const QChar &ch, decomposed)
+        if(ch.category() != QChar::Mark_NonSpacing)
+            result += ch;
+
+    return result.toCaseFolded().simplified();
+}
+
+TelegramFileIndex *TelegramQml::fileIndex() const
+{
+    return &p->fileIndex;
+}
+
 qint64 TelegramQml::messageDialogId(qint64 id) const
 {
-    MessageObject *msg = p->messages.value(id);
-    if(!msg)
+    QHash<qint64,Message>::const_iterator i = p->messages_store.constFind(id);
+    if(i == p->messages_store.constEnd())
         return 0;
 
-    qint64 dId = msg->toId()->chatId();
+    const Message &msg = i.value();
+    qint64 dId = msg.toId().chatId();
     if( dId == 0 )
-        dId = msg->out()? msg->toId()->userId() : msg->fromId();
+        dId = FLAG_TO_OUT(msg.flags())? msg.toId().userId() : msg.fromId();
 
     return dId;
 }
@@ -989,7 +1322,7 @@ StickerPackObject *TelegramQml::stickerPack(const QString &id) const
 FileLocationObject *TelegramQml::locationOf(qint64 id, qint64 dcId, qint64 accessHash, QObject *parent)
 {
     FileLocationObject *obj = p->accessHashes.value(accessHash);
-    if( obj && TqObject::isValid(obj) )
+    if( obj )
         return obj;
 
     FileLocation location(FileLocation::typeFileLocation);
@@ -998,9 +1331,9 @@ FileLocationObject *TelegramQml::locationOf(qint64 id, qint64 dcId, qint64 acces
     obj->setDcId(dcId);
     obj->setAccessHash(accessHash);
 
-    connect(obj, SIGNAL(destroyed(QObject*)), SLOT(objectDestroyed(QObject*)));
-
     p->accessHashes[accessHash] = obj;
+    p->accessHashObjects[obj] = accessHash;
+    connect(obj, SIGNAL(destroyed(QObject*)), SLOT(objectDestroyed(QObject*)));
     return obj;
 }
 
@@ -1561,6 +1894,25 @@ QList<qint64> TelegramQml::stickerSetDocuments(const QString &shortName) const
     return stickerSetDocuments(id);
 }
 
+QList<qint64> TelegramQml::stickersOfEmoticon(const QString &emoticon) const
+{
+    QList<qint64> result;
+    const QSet<qint64> &documents = p->stickerEmoticons.value(normalizeEmoticon(emoticon));
+    Q_FOREACH(qint64 docId, documents)
+        if(p->installedStickerSets.contains(p->stickerDocumentSets.value(docId)))
+            result << docId;
+
+    qSort(result.begin(), result.end());
+    return result;
+}
+
+QString TelegramQml::normalizeEmoticon(const QString &emoticon)
+{
+    QString result = emoticon.trimmed();
+    result.remove(QChar(0xFE0F));
+    return result;
+}
+
 InputUser TelegramQml::getInputUser(qint64 userId) const
 {
     UserObject *user = p->users.value(userId);
@@ -1613,27 +1965,96 @@ InputPeer TelegramQml::getInputPeer(qint64 peerId)
 }
 
 QList<qint64> TelegramQml::userIndex(const QString &kw)
+{
+    return userIndex(kw, QSet<qint64>(), -1);
+}
+
+/*! Users whose name keys contain keyword, limited to scope unless it's
+ *  empty. Prefix matches come first, both groups in key order. A negative
+ *  limit returns every match. !*/
+QList<qint64> TelegramQml::userIndex(const QString &kw, const QSet<qint64> &scope, int limit)
 {
     const QString & keyword = kw.toLower();
 
     QList<qint64> result;
     QSet<qint64> addeds;
 
-    QMapIterator<QString, qint64> i(p->userNameIndexes);
-    while(i.hasNext())
+    /*! Prefix matches are one contiguous range of the sorted index !*/
+    QMap<QString, qint64>::const_iterator i = p->userNameIndexes.lowerBound(keyword);
+    for(; i != p->userNameIndexes.constEnd() && i.key().startsWith(keyword); i++)
     {
-        i.next();
-        qint64 uid = i.value();
-        if(addeds.contains(uid))
-            continue;
-        else
-        if(!i.key().contains(keyword.toLower()))
+        if(limit >= 0 && result.count() >= limit)
+            return result;
+
+        const qint64 uid = i.value();
+        if(addeds.contains(uid) || (!scope.isEmpty() && !scope.contains(uid)))
             continue;
 
         result << uid;
         addeds.insert(uid);
     }
 
+    if(keyword.isEmpty() || (limit >= 0 && result.count() >= limit))
+        return result;
+
+    /*! Then matches inside the keys. Walk whichever side is smaller !*/
+    QMap<QString, qint64> inner;
+    if(!scope.isEmpty() && scope.count() < p->userNameKeys.count())
+    {
+        Q_FOREACH(qint64 uid, scope)
+        {
+            if(addeds.contains(uid))
+                continue;
+
+            const QStringList &keys = p->userNameKeys.value(uid);
+            Q_FOREACH(const QString &key, keys)
+                if(key.contains(keyword))
+                {
+                    inner.insertMulti(key, uid);
+                    break;
+                }
+        }
+    }
+    else
+    {
+        QMapIterator<QString, qint64> j(p->userNameIndexes);
+        while(j.hasNext())
+        {
+            j.next();
+            const qint64 uid = j.value();
+            if(addeds.contains(uid) || (!scope.isEmpty() && !scope.contains(uid)))
+                continue;
+            if(!j.key().contains(keyword))
+                continue;
+
+            inner.insertMulti(j.key(), uid);
+            addeds.insert(uid);
+        }
+    }
+
+    QMapIterator<QString, qint64> j(inner);
+    while(j.hasNext() && (limit < 0 || result.count() < limit))
+    {
+        j.next();
+        result << j.value();
+    }
+
+    return result;
+}
+
+/*! Participant ids of a chat as a set, built once per ChatFull !*/
+QSet<qint64> TelegramQml::chatParticipants(qint64 chatId) const
+{
+    QHash<qint64, QSet<qint64> >::const_iterator i = p->chatParticipantSets.constFind(chatId);
+    if(i != p->chatParticipantSets.constEnd())
+        return i.value();
+
+    ChatFullObject *obj = p->chatfulls.value(chatId);
+    if(!obj)
+        return QSet<qint64>();
+
+    const QSet<qint64> &result = obj->participants()->participants()->userIds().toSet();
+    p->chatParticipantSets[chatId] = result;
     return result;
 }
 
@@ -1796,7 +2217,7 @@ qint32 TelegramQml::sendMessage(qint64 dId, const QString &msg, int replyTo)
 
     insertMessage(message, (dlg && dlg->encrypted()), false, true);
 
-    MessageObject *msgObj = p->messages.value(message.id());
+    MessageObject *msgObj = materializeMessage(message.id());
     msgObj->setSent(false);
 
     p->pend_messages[sendId] = msgObj;
@@ -1863,7 +2284,7 @@ void TelegramQml::sendGeo(qint64 dId, qreal latitude, qreal longitude, int reply
 
     insertMessage(message, (dlg && dlg->encrypted()), false, true);
 
-    MessageObject *msgObj = p->messages.value(message.id());
+    MessageObject *msgObj = materializeMessage(message.id());
     msgObj->setSent(false);
 
     p->pend_messages[sendId] = msgObj;
@@ -1924,11 +2345,10 @@ void TelegramQml::deleteMessages(QList<int> msgIds)
     p->telegram->messagesDeleteMessages( msgIds );
     Q_FOREACH(int msgId, msgIds)
     {
-        MessageObject *msgObj = p->messages.value(msgId);
-        if(msgObj)
+        if(p->messages_store.contains(msgId))
         {
             p->database->deleteMessage(msgId);
-            insertToGarbeges(p->messages.value(msgId));
+            removeMessage(msgId);
 
             Q_EMIT messagesChanged(false);
         }
@@ -2062,7 +2482,7 @@ void TelegramQml::messagesDeleteHistory(qint64 peerId, bool deleteChat, bool use
 
     if (isChat && deleteChat && !userRemoved) {
         // Leave group chat before deleting.
-        messagesGetFullChat(peerId);
+        messagesGetFullChat(peerId, true);
     } else if (p->encchats.contains(peerId)) {
         if (deleteChat == false) {
             qWarning() << "WARNING: Deleting secret chat history without chat removal is not yet unsupported";
@@ -2164,8 +2584,56 @@ qint64 TelegramQml::messagesDiscardEncryptedChat(qint32 chatId, bool force)
     return p->telegram->messagesDiscardEncryptedChat(chatId);
 }
 
-void TelegramQml::messagesGetFullChat(qint32 chatId)
+void TelegramQml::contactsGetContacts()
+{
+    if(!p->telegram || !p->telegram->isConnected())
+        return;
+
+    p->telegram->contactsGetContacts(p->contactsHash);
+}
+
+void TelegramQml::messagesGetDialogs()
+{
+    if(!p->telegram || !p->telegram->isConnected())
+        return;
+
+    if(p->dialogs_sync_timer)
+        killTimer(p->dialogs_sync_timer);
+
+    p->dialogs_sync_timer = 0;
+    p->dialogs_sync_offset = 0;
+    p->dialogs_sync_seen.clear();
+    p->dialogs_sync_start = QDateTime::currentDateTime().toTime_t();
+    p->dialogs_sync_total = -1;
+    p->dialogs_sync_shifted = false;
+    requestDialogsPage();
+}
+
+void TelegramQml::requestDialogsPage()
+{
+    if(!p->telegram || !p->telegram->isConnected())
+    {
+        p->dialogs_sync_request = 0;
+        return;
+    }
+
+    /*! A small first page fills the screen, the rest comes in larger pages !*/
+    p->dialogs_sync_limit = p->dialogs_sync_offset? DIALOGS_PAGE_LIMIT : DIALOGS_FIRST_PAGE_LIMIT;
+    p->dialogs_sync_request = p->telegram->messagesGetDialogs(p->dialogs_sync_offset, 0, p->dialogs_sync_limit);
+}
+
+void TelegramQml::messagesGetFullChat(qint32 chatId, bool force)
 {
+    if(!force && p->chatfulls.contains(chatId))
+    {
+        /*! Serve the cached list right away and revalidate it once it's too old !*/
+        QMetaObject::invokeMethod(this, "chatFullsChanged", Qt::QueuedConnection);
+
+        const qint64 age = QDateTime::currentDateTime().toTime_t() - p->chatfulls_updated.value(chatId);
+        if(age < CHAT_FULL_TTL)
+            return;
+    }
+
     if(!p->telegram)
         return;
 
@@ -2196,6 +2664,25 @@ void TelegramQml::uninstallStickerSet(const QString &shortName)
     p->pending_stickers_uninstall[msgId] = shortName;
 }
 
+void TelegramQml::messagesGetAllStickers()
+{
+    /*! The cached collection and its hash have to be in place before asking the server !*/
+    if(!p->stickersLoaded)
+    {
+        if(p->stickersRequested)
+            return;
+
+        p->stickersRequested = true;
+        p->database->readStickers();
+        return;
+    }
+
+    if(!p->telegram)
+        return;
+
+    p->telegram->messagesGetAllStickers(p->stickersHash);
+}
+
 void TelegramQml::getStickerSet(const QString &shortName)
 {
     if(!p->telegram)
@@ -2226,14 +2713,25 @@ void TelegramQml::getStickerSet(DocumentObject *doc)
 }
 
 void TelegramQml::search(const QString &keyword)
+{
+    searchMessages(keyword);
+}
+
+/*! Searches messages older than maxId (0 for the newest ones) in the
+ *  dialog of peerId, or in all dialogs if peerId is 0. Returns the request
+ *  id that messagesSearched will carry. !*/
+qint64 TelegramQml::searchMessages(const QString &keyword, qint64 peerId, qint32 maxId, int limit)
 {
     if(!p->telegram)
-        return;
+        return 0;
 
     InputPeer peer(InputPeer::typeInputPeerEmpty);
+    if(peerId)
+        peer = getInputPeer(peerId);
+
     MessagesFilter filter(MessagesFilter::typeInputMessagesFilterEmpty);
 
-    p->telegram->messagesSearch(peer, keyword, filter, 0, 0, 0, 0, 50);
+    return p->telegram->messagesSearch(peer, keyword, filter, 0, 0, 0, maxId, limit);
 }
 
 void TelegramQml::searchContact(const QString &keyword)
@@ -2384,7 +2882,7 @@ qint64 TelegramQml::sendFile(qint64 dId, const QString &fpath, bool forceDocumen
 
     insertMessage(message, false, false, true);
 
-    MessageObject *msgObj = p->messages.value(message.id());
+    MessageObject *msgObj = materializeMessage(message.id());
     msgObj->setSent(false);
 
     UploadObject *upload = msgObj->upload();
@@ -2548,8 +3046,9 @@ void TelegramQml::cancelSendGet(qint64 fileId)
     if( !p->telegram )
         return;
 
-    if(p->downloads.contains(fileId))
-        p->downloads.value(fileId)->download()->setFileId(0);
+    FileLocationObject *locObj = p->downloads.value(fileId);
+    if(locObj)
+        locObj->download()->setFileId(0);
 
     p->telegram->uploadCancelFile(fileId);
 }
@@ -2615,8 +3114,8 @@ void TelegramQml::cleanUpMessages()
     if( !p->autoCleanUpMessages && p->messagesModels.contains(static_cast<TelegramMessagesModel*>(sender())) )
         return;
 
-    p->cleanUpTimer->stop();
-    p->cleanUpTimer->start();
+    if(!p->cleanUpTimer->isActive())
+        p->cleanUpTimer->start();
 }
 
 void TelegramQml::updatesGetState()
@@ -2634,8 +3133,10 @@ void TelegramQml::updatesGetDifference()
 {
     if(!p->telegram)
         return;
+    if(p->difference_request)
+        return;
 
-    p->telegram->updatesGetDifference(p->state.pts(), p->state.date(), p->state.qts());
+    p->difference_request = p->telegram->updatesGetDifference(p->state.pts(), p->state.date(), p->state.qts());
 }
 
 bool TelegramQml::sleep()
@@ -2654,123 +3155,368 @@ bool TelegramQml::wake()
     return p->telegram->wake();
 }
 
+/*! Wrappers parked as locked don't count against the limit, otherwise
+ *  more dialogs than the limit would keep the cleanup running !*/
+bool TelegramQml::messagesCacheFull() const
+{
+    return p->messagesCacheLimit >= 0 && p->messages.count() - p->messages_locked.count() > p->messagesCacheLimit;
+}
+
 void TelegramQml::cleanUpMessages_prv()
 {
-    QSet<qint32> lockedMessages;
+    cleanUpMessagesStore_prv();
+    if(!messagesCacheFull())
+        return;
 
-    /*! Find messages shouldn't be delete !*/
-    Q_FOREACH(DialogObject *dlg, p->dialogs)
+    /*! Messages in flight are owned by their requests !*/
+    QSet<MessageObject*> lockedMessages;
+    Q_FOREACH(MessageObject *msg, p->pend_messages)
+        lockedMessages.insert(msg);
+    Q_FOREACH(MessageObject *msg, p->uploads)
+        lockedMessages.insert(msg);
+    Q_FOREACH(const QPointer<FileLocationObject> &obj, p->downloads)
     {
-        qint32 msgId = dlg->topMessage();
-        if(msgId)
-            lockedMessages.insert(msgId);
+        QObject *parent = obj;
+        while(parent && !qobject_cast<MessageObject*>(parent))
+            parent = parent->parent();
+        if(!parent)
+            continue;
+
+        lockedMessages.insert(static_cast<MessageObject*>(parent));
     }
 
-    Q_FOREACH(TelegramSearchModel *mdl, p->searchModels)
+    /*! Locked wrappers are parked outside the lru instead of being rotated
+     *  through it. Released ones go back as the oldest entries. !*/
+    const QSet<qint64> parked = p->messages_locked;
+    Q_FOREACH(qint64 msgId, parked)
     {
-        const QList<qint64> &list = mdl->messages();
-        Q_FOREACH(qint64 mId, list)
-            lockedMessages.insert(mId);
+        MessageObject *msg = p->messages.value(msgId);
+        if(msg)
+        {
+            DialogObject *dlg = p->dialogs.value(messageDialogId(msgId));
+            if(lockedMessages.contains(msg) || (dlg && dlg->topMessage() == msgId))
+                continue;
+
+            p->messages_lru_index[msgId] = p->messages_lru.insert(p->messages_lru.begin(), msgId);
+        }
+
+        p->messages_locked.remove(msgId);
     }
 
-    Q_FOREACH(TelegramMessagesModel *mdl, p->messagesModels)
+    /*! Drop least recently used wrappers, the raw values stay in the store.
+     *  Every entry leaves the lru here, so this ends once it's empty. !*/
+    while(!p->messages_lru.isEmpty() && messagesCacheFull())
     {
-        DialogObject *dlg = mdl->dialog();
-        if(!dlg)
+        const qint64 msgId = p->messages_lru.takeFirst();
+        p->messages_lru_index.remove(msgId);
+
+        MessageObject *msg = p->messages.value(msgId);
+        if(!msg)
             continue;
 
-        qint64 dId = dlg->peer()->userId();
-        if(!dId)
-            dId = dlg->peer()->chatId();
-        if(!dId)
+        DialogObject *dlg = p->dialogs.value(messageDialogId(msgId));
+        if(lockedMessages.contains(msg) || (dlg && dlg->topMessage() == msgId))
+        {
+            p->messages_locked.insert(msgId);
             continue;
+        }
 
-        const QList<qint64> &list = p->messages_list.value(dId);
-        Q_FOREACH(qint64 mId, list)
-            lockedMessages.insert(mId);
+        p->messages.remove(msgId);
+        msg->deleteLater();
     }
+}
 
-    Q_FOREACH(qint64 msg, p->pend_messages.keys())
-        lockedMessages.insert(msg);
-    Q_FOREACH(qint64 msg, p->uploads.keys())
-        lockedMessages.insert(msg);
-    Q_FOREACH(FileLocationObject *obj, p->downloads)
-    {
-        QObject *parent = obj;
-        while(parent && TqObject::isValid(tqobject_cast(parent)) && !qobject_cast<MessageObject*>(parent))
-            parent = parent->parent();
-        if(!parent)
-            continue;
+/*! Pinned and top messages are never evicted, so they don't count
+ *  against the store budget. Pins of messages that aren't stored make
+ *  this a lower bound, which only delays the eviction. !*/
+bool TelegramQml::messagesStoreFull() const
+{
+    return p->messagesStoreLimit >= 0 &&
+           p->messages_store.count() - p->messages_pins.count() - p->dialogs.count() > p->messagesStoreLimit;
+}
 
-        lockedMessages.insert(static_cast<MessageObject*>(parent)->id());
-    }
-    Q_FOREACH(FileLocationObject *obj, p->accessHashes)
+/*! Raw values have their own, much larger budget than the wrappers. Only
+ *  history of dialogs without a messages model is dropped, oldest first,
+ *  and never pinned, wrapped or top messages. Models read it back from
+ *  the database. !*/
+void TelegramQml::cleanUpMessagesStore_prv()
+{
+    if(!messagesStoreFull())
+        return;
+
+    QHash<qint64, QList<qint64> >::iterator i = p->messages_list.begin();
+    while(i != p->messages_list.end() && messagesStoreFull())
     {
-        QObject *parent = obj;
-        while(parent && TqObject::isValid(tqobject_cast(parent)) && !qobject_cast<MessageObject*>(parent))
-            parent = parent->parent();
-        if(!parent)
+        const qint64 dId = i.key();
+        if(p->messagesModelsOfDialog.contains(dId))
+        {
+            ++i;
             continue;
+        }
 
-        lockedMessages.insert(static_cast<MessageObject*>(parent)->id());
-    }
+        DialogObject *dlg = p->dialogs.value(dId);
+        const qint64 topMessage = dlg? dlg->topMessage() : 0;
 
-    /*! Delete expired messages !*/
-    QHashIterator<qint64, QList<qint64> > mli(p->messages_list);
-    while(mli.hasNext())
-    {
-        mli.next();
-        QList<qint64> messages = mli.value();
-        for(int i=0; i<messages.count(); i++)
+        QList<qint64> &list = i.value();
+        for(int j=list.count()-1; j>=0 && messagesStoreFull(); j--)
         {
-            qint64 msgId = messages.at(i);
-            if(lockedMessages.contains(msgId))
+            const qint64 msgId = list.at(j);
+            if(msgId == topMessage || p->messages_pins.contains(msgId) || p->messages.contains(msgId))
                 continue;
 
-            messages.removeAt(i);
-            i--;
+            list.removeAt(j);
+            p->messages_store.remove(msgId);
+            p->messages_dates.remove(msgId);
+            p->encrypted_messages.remove(msgId);
+            p->messages_media_keys.remove(msgId);
         }
 
-        p->messages_list[mli.key()] = messages;
+        if(list.isEmpty())
+            i = p->messages_list.erase(i);
+        else
+            ++i;
     }
+}
 
-    Q_FOREACH(MessageObject *msg, p->messages)
-        if(!lockedMessages.contains(msg->id()))
-        {
-            p->messages.remove(msg->id());
-            msg->deleteLater();
-        }
+MessageObject *TelegramQml::materializeMessage(qint64 msgId) const
+{
+    MessageObject *res = p->messages.value(msgId);
+    if(res)
+    {
+        touchMessage(msgId);
+        return res;
+    }
 
-    Q_EMIT dialogsChanged(false);
-    Q_EMIT messagesChanged(false);
+    QHash<qint64,Message>::const_iterator i = p->messages_store.constFind(msgId);
+    if(i == p->messages_store.constEnd())
+        return 0;
+
+    res = new MessageObject(i.value(), const_cast<TelegramQml*>(this));
+    res->setEncrypted(p->encrypted_messages.contains(msgId));
+    if(p->messages_media_keys.contains(msgId))
+    {
+        const QPair<QByteArray,QByteArray> &keys = p->messages_media_keys.value(msgId);
+        res->media()->setEncryptKey(keys.first);
+        res->media()->setEncryptIv(keys.second);
+    }
+
+    p->messages.insert(msgId, res);
+    touchMessage(msgId);
+
+    if(p->autoCleanUpMessages && messagesCacheFull() && !p->cleanUpTimer->isActive())
+        p->cleanUpTimer->start();
+
+    return res;
 }
 
-bool TelegramQml::requestReadMessage(qint32 msgId)
+void TelegramQml::removeMessage(qint64 msgId)
 {
-    if(p->request_messages.contains(msgId))
-        return false;
+    MessageObject *msg = p->messages.value(msgId);
+    if(msg)
+    {
+        insertToGarbeges(msg);
+        return;
+    }
 
-    p->request_messages << msgId;
+    const qint64 dId = messageDialogId(msgId);
+    p->messages_list[dId].removeAll(msgId);
+    p->messages_store.remove(msgId);
+    p->messages_dates.remove(msgId);
+    p->encrypted_messages.remove(msgId);
+    p->messages_media_keys.remove(msgId);
 
-    p->messageRequester->stop();
-    p->messageRequester->start();
-    return true;
+    Q_FOREACH(TelegramMessagesModel *model, p->messagesModelsOfDialog.value(dId))
+        model->removeMessageRow(msgId);
 }
 
-void TelegramQml::requestReadMessage_prv()
+void TelegramQml::touchMessage(qint64 msgId) const
 {
-    if(!p->telegram)
-        return;
-    if(p->request_messages.isEmpty())
+    if(p->messages_pins.contains(msgId))
         return;
 
-    p->telegram->messagesGetMessages(p->request_messages);
-    p->request_messages.clear();
+    p->messages_locked.remove(msgId);
+    QHash<qint64, QLinkedList<qint64>::iterator>::iterator i = p->messages_lru_index.find(msgId);
+    if(i != p->messages_lru_index.end())
+        p->messages_lru.erase(i.value());
+
+    p->messages_lru_index[msgId] = p->messages_lru.insert(p->messages_lru.end(), msgId);
 }
 
-void TelegramQml::removeFiles(const QString &dir)
+void TelegramQml::forgetMessage(qint64 msgId)
 {
-    const QStringList dirs = QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    p->messages_locked.remove(msgId);
+    QHash<qint64, QLinkedList<qint64>::iterator>::iterator i = p->messages_lru_index.find(msgId);
+    if(i == p->messages_lru_index.end())
+        return;
+
+    p->messages_lru.erase(i.value());
+    p->messages_lru_index.erase(i);
+}
+
+bool TelegramQml::fetchMissing(TelegramQmlFetchQueue &queue, qint32 id, qint32 source)
+{
+    if(source && !queue.sources.contains(id))
+        queue.sources.insert(id, source);
+    if(queue.tries.contains(id))
+        return false;
+
+    queue.tries.insert(id, 0);
+    queue.database << id;
+
+    if(!p->fetchTimer->isActive())
+        p->fetchTimer->start();
+    return true;
+}
+
+void TelegramQml::fetchMissing_prv()
+{
+    if(p->fetch_messages.database.isEmpty() && p->fetch_users.database.isEmpty() &&
+       p->fetch_chats.database.isEmpty())
+        return;
+
+    /*! Ask the local cache first, whatever it can't find goes to the network !*/
+    const QList<qint32> messages = p->fetch_messages.database;
+    const QList<qint32> users = p->fetch_users.database;
+    const QList<qint32> chats = p->fetch_chats.database;
+    p->fetch_messages.database.clear();
+    p->fetch_users.database.clear();
+    p->fetch_chats.database.clear();
+
+    p->database->fetchMissing(messages, users, chats);
+}
+
+void TelegramQml::dbMissingFetched(const QList<qint32> &messages, const QList<qint32> &users, const QList<qint32> &chats)
+{
+    Q_FOREACH(qint32 id, messages)
+        if(p->fetch_messages.tries.contains(id))
+            p->fetch_messages.network << id;
+    Q_FOREACH(qint32 id, users)
+        if(p->fetch_users.tries.contains(id))
+            p->fetch_users.network << id;
+    Q_FOREACH(qint32 id, chats)
+        if(p->fetch_chats.tries.contains(id))
+            p->fetch_chats.network << id;
+
+    sendFetchRequests();
+}
+
+void TelegramQml::sendFetchRequests()
+{
+    if(p->fetch_messages.network.isEmpty() && p->fetch_users.network.isEmpty() &&
+       p->fetch_chats.network.isEmpty())
+        return;
+
+    /*! Keep the queues and try again later, instead of leaving them behind !*/
+    if(!p->telegram)
+    {
+        p->fetchRetryTimer->start();
+        return;
+    }
+
+    QList<qint32> messages;
+    QSet<qint32> messagesSet;
+    Q_FOREACH(qint32 id, p->fetch_messages.network)
+    {
+        p->fetch_messages.tries[id]++;
+        if(!messagesSet.contains(id))
+        {
+            messagesSet.insert(id);
+            messages << id;
+        }
+    }
+    p->fetch_messages.network.clear();
+
+    /*! Only contacts can be asked for without an access hash. Other users
+     *  and chats are resolved by fetching the message that referenced them,
+     *  which returns them along with it. !*/
+    QList<InputUser> contacts;
+    Q_FOREACH(qint32 id, p->fetch_users.network)
+    {
+        if(p->contacts.contains(id))
+        {
+            InputUser input(InputUser::typeInputUserContact);
+            input.setUserId(id);
+            contacts << input;
+        }
+        else
+        if(p->fetch_users.sources.contains(id))
+        {
+            const qint32 source = p->fetch_users.sources.value(id);
+            if(!messagesSet.contains(source))
+            {
+                messagesSet.insert(source);
+                messages << source;
+            }
+        }
+        else
+        {
+            p->fetch_users.tries.remove(id);
+            continue;
+        }
+
+        p->fetch_users.tries[id]++;
+    }
+    p->fetch_users.network.clear();
+
+    Q_FOREACH(qint32 id, p->fetch_chats.network)
+    {
+        p->fetch_chats.tries[id]++;
+        if(!p->fetch_chats.sources.contains(id))
+        {
+            p->telegram->messagesGetFullChat(id);
+            continue;
+        }
+
+        const qint32 source = p->fetch_chats.sources.value(id);
+        if(!messagesSet.contains(source))
+        {
+            messagesSet.insert(source);
+            messages << source;
+        }
+    }
+    p->fetch_chats.network.clear();
+
+    for(int i=0; i<messages.count(); i+=FETCH_BATCH_LIMIT)
+        p->telegram->messagesGetMessages(messages.mid(i, FETCH_BATCH_LIMIT));
+    for(int i=0; i<contacts.count(); i+=FETCH_BATCH_LIMIT)
+        p->telegram->usersGetUsers(contacts.mid(i, FETCH_BATCH_LIMIT));
+
+    p->fetchRetryTimer->start();
+}
+
+void TelegramQml::fetchRetry_prv()
+{
+    TelegramQmlFetchQueue *queues[] = {&p->fetch_messages, &p->fetch_users, &p->fetch_chats};
+    for(int i=0; i<3; i++)
+    {
+        TelegramQmlFetchQueue *queue = queues[i];
+        QHash<qint32,int>::iterator j = queue->tries.begin();
+        while(j != queue->tries.end())
+        {
+            if(j.value() == 0) /*! Still waiting for the database !*/
+                ++j;
+            else
+            if(j.value() < FETCH_MAX_TRIES)
+            {
+                queue->network << j.key();
+                ++j;
+            }
+            else
+            {
+                if(queue == &p->fetch_messages)
+                    p->pending_replies.remove(j.key());
+                queue->sources.remove(j.key());
+                j = queue->tries.erase(j);
+            }
+        }
+    }
+
+    sendFetchRequests();
+}
+
+void TelegramQml::removeFiles(const QString &dir)
+{
+    const QStringList dirs = QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
     Q_FOREACH(const QString &d, dirs)
         removeFiles(dir + "/" + d);
 
@@ -2804,6 +3550,7 @@ void TelegramQml::try_init()
     p->telegram = new Telegram(p->defaultHostAddress,p->defaultHostPort,p->defaultHostDcId,
                                p->appId, p->appHash, p->phoneNumber, p->configPath, pKeyFile);
     p->tsettings = p->telegram->settings();
+    p->difference_request = 0;
 
     connect( p->telegram, SIGNAL(authNeeded())                          , SLOT(authNeeded_slt())                           );
     connect( p->telegram, SIGNAL(authLoggedIn())                        , SLOT(authLoggedIn_slt())                         );
@@ -3181,9 +3928,11 @@ void TelegramQml::authSignUpError_slt(qint64 id, qint32 errorCode, QString error
 
 void TelegramQml::error_slt(qint64 id, qint32 errorCode, QString errorText, QString functionName)
 {
-    Q_UNUSED(id)
     Q_UNUSED(errorCode)
 
+    if(id == p->difference_request)
+        p->difference_request = 0;
+
     p->error = errorText;
     Q_EMIT errorChanged();
 
@@ -3308,11 +4057,41 @@ void TelegramQml::contactsFound_slt(qint64 id, const QList<ContactFound> &founds
 void TelegramQml::contactsGetContacts_slt(qint64 id, bool modified, const QList<Contact> &contacts, const QList<User> &users)
 {
     Q_UNUSED(id)
+    if(!modified) /*! The server list matches our hash !*/
+        return;
 
     Q_FOREACH( const User & user, users )
-        insertUser(user, modified);
+        insertUser(user);
+
+    QSet<qint64> removedContacts = p->contacts.keys().toSet();
+    QList<qint32> ids;
     Q_FOREACH( const Contact & contact, contacts )
-        insertContact(contact, modified);
+    {
+        removedContacts.remove(contact.userId());
+        ids << contact.userId();
+
+        ContactObject *obj = p->contacts.value(contact.userId());
+        if(obj && obj->mutual() == contact.mutual())
+            continue;
+
+        insertContact(contact, false, false);
+    }
+
+    Q_FOREACH( qint64 userId, removedContacts )
+    {
+        insertToGarbeges(p->contacts.take(userId));
+        p->database->deleteContact(userId);
+    }
+
+    qSort(ids);
+    QStringList idStrings;
+    Q_FOREACH( qint32 userId, ids )
+        idStrings << QString::number(userId);
+
+    p->contactsHash = QCryptographicHash::hash(idStrings.join(",").toUtf8(), QCryptographicHash::Md5).toHex();
+    p->database->setValue(DATABASE_CONTACTS_HASH_KEY, p->contactsHash);
+
+    Q_EMIT contactsChanged();
 }
 
 void TelegramQml::usersGetFullUser_slt(qint64 id, const User &user, const ContactsLink &link, const Photo &profilePhoto, const PeerNotifySettings &notifySettings, bool blocked, const QString &realFirstName, const QString &realLastName)
@@ -3371,11 +4150,11 @@ void TelegramQml::messagesSendMessage_slt(qint64 id, qint32 msgId, qint32 date,
     if( !did )
         did = msgObj->out()? msg.toId().userId() : msg.fromId();
 
-    insertToGarbeges(p->messages.value(old_msgId));
+    removeMessage(old_msgId);
     insertMessage(msg);
     timerUpdateDialogs(3000);
 
-    Q_EMIT messageSent(id, p->messages.value(msgId));
+    Q_EMIT messageSent(id, materializeMessage(msgId));
     Q_EMIT messagesSent(1);
 }
 
@@ -3423,7 +4202,7 @@ void TelegramQml::messagesSendMedia_slt(qint64 id, const UpdatesType &updates)
 
     qint64 old_msgId = uplMsg->id();
 
-    insertToGarbeges(p->messages.value(old_msgId));
+    removeMessage(old_msgId);
     insertUpdates(updates);
     timerUpdateDialogs(3000);
 
@@ -3435,7 +4214,7 @@ void TelegramQml::messagesSendPhoto_slt(qint64 id, const UpdatesType &updates)
     MessageObject *uplMsg = p->uploads.value(id);
     qint64 old_msgId = uplMsg->id();
 
-    insertToGarbeges(p->messages.value(old_msgId));
+    removeMessage(old_msgId);
     insertUpdates(updates);
     timerUpdateDialogs(3000);
 
@@ -3447,7 +4226,7 @@ void TelegramQml::messagesSendVideo_slt(qint64 id, const UpdatesType &updates)
     MessageObject *uplMsg = p->uploads.value(id);
     qint64 old_msgId = uplMsg->id();
 
-    insertToGarbeges(p->messages.value(old_msgId));
+    removeMessage(old_msgId);
     insertUpdates(updates);
     timerUpdateDialogs(3000);
 
@@ -3459,7 +4238,7 @@ void TelegramQml::messagesSendAudio_slt(qint64 id, const UpdatesType &updates)
     MessageObject *uplMsg = p->uploads.value(id);
     qint64 old_msgId = uplMsg->id();
 
-    insertToGarbeges(p->messages.value(old_msgId));
+    removeMessage(old_msgId);
     insertUpdates(updates);
     timerUpdateDialogs(3000);
 }
@@ -3469,7 +4248,7 @@ void TelegramQml::messagesSendDocument_slt(qint64 id, const UpdatesType &updates
     MessageObject *uplMsg = p->uploads.value(id);
     qint64 old_msgId = uplMsg->id();
 
-    insertToGarbeges(p->messages.value(old_msgId));
+    removeMessage(old_msgId);
     insertUpdates(updates);
     timerUpdateDialogs(3000);
 
@@ -3515,35 +4294,99 @@ void TelegramQml::messagesForwardDocument_slt(qint64 id, const UpdatesType &upda
 
 void TelegramQml::messagesGetDialogs_slt(qint64 id, qint32 sliceCount, const QList<Dialog> &dialogs, const QList<Message> &messages, const QList<Chat> &chats, const QList<User> &users)
 {
-    Q_UNUSED(id)
-    Q_UNUSED(sliceCount)
+    const bool paged = (id && id == p->dialogs_sync_request);
+    if(paged)
+        p->dialogs_sync_request = 0;
 
-    Q_FOREACH( const User & u, users )
-        insertUser(u);
-    Q_FOREACH( const Chat & c, chats )
-        insertChat(c);
-    Q_FOREACH( const Message & m, messages )
-        insertMessage(m);
-
-    QSet<qint64> removedDialogs = p->dialogs_list.toSet();
+    bool changed = !paged;
     Q_FOREACH( const Dialog & d, dialogs )
     {
-        insertDialog(d);
+        if(changed)
+            break;
+
         qint64 dialogId = d.peer().chatId()?d.peer().chatId():d.peer().userId();
-        removedDialogs.remove(dialogId);
+        DialogObject *obj = p->dialogs.value(dialogId);
+        if(!obj || obj->topMessage() != d.topMessage() || obj->unreadCount() != d.unreadCount())
+            changed = true;
     }
 
-    if(p->database) {
-        Q_FOREACH(qint64 dId, removedDialogs)
+    if(changed)
+    {
+        Q_FOREACH( const User & u, users )
+            insertUser(u);
+        Q_FOREACH( const Chat & c, chats )
+            insertChat(c);
+        Q_FOREACH( const Message & m, messages )
+            insertMessage(m);
+        Q_FOREACH( const Dialog & d, dialogs )
+            insertDialog(d);
+    }
+
+    if(paged)
+    {
+        /*! The list is ordered by activity, so a dialog that becomes active
+         *  or goes away during the walk shifts the offsets of later pages.
+         *  Such a walk can't tell which dialogs are gone. !*/
+        QHash<qint64, qint32> dates;
+        Q_FOREACH( const Message & m, messages )
+            dates[m.id()] = m.date();
+
+        Q_FOREACH( const Dialog & d, dialogs )
         {
-            if(p->dialogs[dId]->encrypted())
-                continue;
+            p->dialogs_sync_seen.insert(d.peer().chatId()?d.peer().chatId():d.peer().userId());
+            if(dates.value(d.topMessage()) >= p->dialogs_sync_start)
+                p->dialogs_sync_shifted = true;
+        }
 
-            p->database->deleteDialog(dId);
-            insertToGarbeges(p->dialogs.value(dId));
+        if(p->dialogs_sync_total == -1)
+            p->dialogs_sync_total = sliceCount;
+        else
+        if(p->dialogs_sync_total != sliceCount)
+            p->dialogs_sync_shifted = true;
+
+        p->dialogs_sync_offset += dialogs.count();
+        const bool finished = dialogs.count() < p->dialogs_sync_limit ||
+                              (sliceCount && p->dialogs_sync_offset >= sliceCount);
+
+        if(finished)
+        {
+            /*! Only a complete, undisturbed walk can tell a dialog is gone,
+             *  and only if it was idle since before the walk started !*/
+            QSet<qint64> removedDialogs;
+            if(!p->dialogs_sync_shifted)
+            {
+                removedDialogs = p->dialogs_list.toSet();
+                removedDialogs.subtract(p->dialogs_sync_seen);
+            }
+            p->dialogs_sync_seen.clear();
+
+            if(p->database) {
+                Q_FOREACH(qint64 dId, removedDialogs)
+                {
+                    DialogObject *dlg = p->dialogs.value(dId);
+                    if(!dlg || dlg->encrypted())
+                        continue;
+
+                    const qint32 topDate = p->messages_dates.value(dlg->topMessage());
+                    if(!topDate || topDate >= p->dialogs_sync_start)
+                        continue;
+
+                    p->database->deleteDialog(dId);
+                    insertToGarbeges(dlg);
+                    changed = true;
+                }
+            }
         }
+        else
+        if(changed)
+            p->dialogs_sync_timer = startTimer(DIALOGS_PAGE_DELAY);
+        else
+            p->dialogs_sync_seen.clear(); /*! Dialogs are ordered by activity, the rest is in sync already !*/
     }
 
+    if(!changed)
+        return;
+
     Q_EMIT dialogsChanged(false);
     refreshSecretChats();
 }
@@ -3609,7 +4452,6 @@ void TelegramQml::messagesDeleteHistory_slt(qint64 id, qint32 pts, qint32 seq, q
 
 void TelegramQml::messagesSearch_slt(qint64 id, qint32 sliceCount, const QList<Message> &messages, const QList<Chat> &chats, const QList<User> &users)
 {
-    Q_UNUSED(id)
     Q_UNUSED(sliceCount)
 
     QList<qint64> res;
@@ -3625,6 +4467,7 @@ void TelegramQml::messagesSearch_slt(qint64 id, qint32 sliceCount, const QList<M
     }
 
     Q_EMIT searchDone(res);
+    Q_EMIT messagesSearched(id, res);
 }
 
 void TelegramQml::messagesGetFullChat_slt(qint64 id, const ChatFull &chatFull, const QList<Chat> &chats, const QList<User> &users)
@@ -3635,16 +4478,10 @@ void TelegramQml::messagesGetFullChat_slt(qint64 id, const ChatFull &chatFull, c
     Q_FOREACH( const Chat & c, chats )
         insertChat(c);
 
-    ChatFullObject *obj = p->chatfulls.value(chatFull.id());
-    if( !obj )
-    {
-        obj = new ChatFullObject(chatFull, this);
-        p->chatfulls.insert(chatFull.id(), obj);
-    }
-    else
-        *obj = chatFull;
+    insertChatFull(chatFull);
 
     qint64 peerId = chatFull.id();
+    ChatFullObject *obj = p->chatfulls.value(peerId);
     if(p->deleteChatIds.contains(peerId)) {
         ChatParticipantsObject* object = obj->participants();
         ChatParticipantList* list = object->participants();
@@ -3656,8 +4493,6 @@ void TelegramQml::messagesGetFullChat_slt(qint64 id, const ChatFull &chatFull, c
             messagesDeleteHistory(peerId, true, true);
         }
     }
-
-    Q_EMIT chatFullsChanged();
 }
 
 void TelegramQml::messagesCreateChat_slt(qint64 id, const UpdatesType &updates)
@@ -3789,7 +4624,7 @@ void TelegramQml::messagesSendEncrypted_slt(qint64 id, qint32 date, const Encryp
     if( !did )
         did = FLAG_TO_OUT(msg.flags())? msg.toId().userId() : msg.fromId();
 
-    insertToGarbeges(p->messages.value(old_msgId));
+    removeMessage(old_msgId);
     insertMessage(msg);
     timerUpdateDialogs(3000);
 }
@@ -3905,7 +4740,7 @@ void TelegramQml::messagesSendEncryptedFile_slt(qint64 id, qint32 date, const En
     if( !did )
         did = FLAG_TO_OUT(msg.flags())? msg.toId().userId() : msg.fromId();
 
-    insertToGarbeges(p->messages.value(old_msgId));
+    removeMessage(old_msgId);
     insertMessage(msg, true);
     insertDialog(dialog, true);
     timerUpdateDialogs(3000);
@@ -3923,17 +4758,26 @@ void TelegramQml::messagesGetStickers_slt(qint64 msgId, const MessagesStickers &
 void TelegramQml::messagesGetAllStickers_slt(qint64 msgId, const MessagesAllStickers &stickers)
 {
     Q_UNUSED(msgId)
+    if(stickers.classType() == MessagesAllStickers::typeMessagesAllStickersNotModified)
+        return;
 
+    insertAllStickers(stickers);
+    p->stickersHash = stickers.hash();
+    p->database->insertStickers(stickers);
+}
+
+void TelegramQml::insertAllStickers(const MessagesAllStickers &stickers, bool fromDb)
+{
     p->installedStickerSets.clear();
 
     const QList<StickerPack> &packs = stickers.packs();
     Q_FOREACH(const StickerPack &pack, packs)
-        insertStickerPack(pack);
+        insertStickerPack(pack, fromDb);
 
     const QList<StickerSet> &sets = stickers.sets();
     Q_FOREACH(const StickerSet &set, sets)
     {
-        insertStickerSet(set);
+        insertStickerSet(set, fromDb);
         p->installedStickerSets.insert(set.id());
         p->stickerShortIds[set.shortName()] = set.id();
     }
@@ -3941,7 +4785,7 @@ void TelegramQml::messagesGetAllStickers_slt(qint64 msgId, const MessagesAllStic
     const QList<Document> &documents = stickers.documents();
     Q_FOREACH(const Document &doc, documents)
     {
-        insertDocument(doc);
+        insertDocument(doc, fromDb);
         p->stickers << doc.id();
 
         const QList<DocumentAttribute> &attrs = doc.attributes();
@@ -3995,7 +4839,7 @@ void TelegramQml::messagesInstallStickerSet_slt(qint64 msgId, bool ok)
             Q_EMIT installedStickersChanged();
         }
         else
-            p->telegram->messagesGetAllStickers(QString());
+            messagesGetAllStickers();
     }
 
     Q_EMIT stickerInstalled(shortId, ok);
@@ -4024,8 +4868,8 @@ void TelegramQml::updatesTooLong_slt()
 
 void TelegramQml::updateShortMessage_slt(qint32 id, qint32 userId, QString message, qint32 pts, qint32 pts_count, qint32 date, qint32 fwd_from_id, qint32 fwd_date, qint32 reply_to_msg_id, bool unread, bool out)
 {
-    Q_UNUSED(pts)
-    Q_UNUSED(pts_count)
+    if(!acceptPts(pts, pts_count))
+        return;
 
     Peer to_peer(Peer::typePeerUser);
     to_peer.setUserId(out?userId:p->telegram->ourId());
@@ -4063,7 +4907,7 @@ void TelegramQml::updateShortMessage_slt(qint32 id, qint32 userId, QString messa
 
     timerUpdateDialogs(3000);
 
-    Q_EMIT incomingMessage( p->messages.value(msg.id()) );
+    Q_EMIT incomingMessage( materializeMessage(msg.id()) );
 
     if (!out) {
         Q_EMIT messagesReceived(1);
@@ -4072,8 +4916,8 @@ void TelegramQml::updateShortMessage_slt(qint32 id, qint32 userId, QString messa
 
 void TelegramQml::updateShortChatMessage_slt(qint32 id, qint32 fromId, qint32 chatId, QString message, qint32 pts, qint32 pts_count, qint32 date, qint32 fwd_from_id, qint32 fwd_date, qint32 reply_to_msg_id, bool unread, bool out)
 {
-    Q_UNUSED(pts)
-    Q_UNUSED(pts_count)
+    if(!acceptPts(pts, pts_count))
+        return;
 
     Peer to_peer(Peer::typePeerChat);
     to_peer.setChatId(chatId);
@@ -4108,7 +4952,7 @@ void TelegramQml::updateShortChatMessage_slt(qint32 id, qint32 fromId, qint32 ch
 
     timerUpdateDialogs(3000);
 
-    Q_EMIT incomingMessage( p->messages.value(msg.id()) );
+    Q_EMIT incomingMessage( materializeMessage(msg.id()) );
 
     if (!out) {
         Q_EMIT messagesReceived(1);
@@ -4118,32 +4962,33 @@ void TelegramQml::updateShortChatMessage_slt(qint32 id, qint32 fromId, qint32 ch
 void TelegramQml::updateShort_slt(const Update &update, qint32 date)
 {
     Q_UNUSED(date)
-    insertUpdate(update);
+    queueUpdate(update);
 }
 
 void TelegramQml::updatesCombined_slt(const QList<Update> & updates, const QList<User> & users, const QList<Chat> & chats, qint32 date, qint32 seqStart, qint32 seq)
 {
-    Q_UNUSED(date)
-    Q_UNUSED(seq)
-    Q_UNUSED(seqStart)
-    Q_FOREACH( const Update & u, updates )
-        insertUpdate(u);
-    Q_FOREACH( const User & u, users )
-        insertUser(u);
-    Q_FOREACH( const Chat & c, chats )
-        insertChat(c);
+    TelegramQmlUpdatesBlock block;
+    block.updates = updates;
+    block.users = users;
+    block.chats = chats;
+    block.date = date;
+    block.seqStart = seqStart;
+    block.seq = seq;
+
+    queueUpdatesBlock(block);
 }
 
 void TelegramQml::updates_slt(const QList<Update> & updates, const QList<User> & users, const QList<Chat> & chats, qint32 date, qint32 seq)
 {
-    Q_UNUSED(date)
-    Q_UNUSED(seq)
-    Q_FOREACH( const Update & u, updates )
-        insertUpdate(u);
-    Q_FOREACH( const User & u, users )
-        insertUser(u);
-    Q_FOREACH( const Chat & c, chats )
-        insertChat(c);
+    TelegramQmlUpdatesBlock block;
+    block.updates = updates;
+    block.users = users;
+    block.chats = chats;
+    block.date = date;
+    block.seqStart = seq;
+    block.seq = seq;
+
+    queueUpdatesBlock(block);
 }
 
 void TelegramQml::updateSecretChatMessage_slt(const SecretChatMessage &secretChatMessage, qint32 qts)
@@ -4154,35 +4999,77 @@ void TelegramQml::updateSecretChatMessage_slt(const SecretChatMessage &secretCha
 
 void TelegramQml::updatesGetDifference_slt(qint64 id, const QList<Message> &messages, const QList<SecretChatMessage> &secretChatMessages, const QList<Update> &otherUpdates, const QList<Chat> &chats, const QList<User> &users, const UpdatesState &state, bool isIntermediateState)
 {
-    Q_UNUSED(id)
-    Q_UNUSED(state)
-    Q_UNUSED(isIntermediateState)
+    if(id == p->difference_request)
+        p->difference_request = 0;
+
+    /*! Queue the difference and apply it in time slices, so a long
+     *  offline period doesn't block the event loop !*/
+    TelegramQmlDifference &diff = p->difference;
+    diff.users << users;
+    diff.chats << chats;
+    diff.updates << otherUpdates;
+    diff.messages << messages;
+    diff.secretChatMessages << secretChatMessages;
+    diff.state = state;
+    diff.intermediate = isIntermediateState;
 
+    if(!p->differenceApplier->isActive())
+        p->differenceApplier->start();
+}
+
+void TelegramQml::applyDifferenceSlice()
+{
     // Count messages received today for basic stats.
     // On Ubuntu, they can be shown on the lock screen.
-    qint32 receivedMessageCount = 0;
-    QDate today = QDate::currentDate();
-
-    Q_FOREACH( const Update & u, otherUpdates )
-        insertUpdate(u);
-    Q_FOREACH( const User & u, users )
-        insertUser(u);
-    Q_FOREACH( const Chat & c, chats )
-        insertChat(c);
-    Q_FOREACH( const Message & m, messages ) {
-        insertMessage(m);
+    const QDate today = QDate::currentDate();
+    TelegramQmlDifference &diff = p->difference;
 
-        if (!FLAG_TO_OUT(m.flags())) {
-            QDate messageDate = QDateTime::fromTime_t(m.date()).date();
-            if (today == messageDate) {
-                receivedMessageCount += 1;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while(elapsed.elapsed() < DIFFERENCE_SLICE_TIME)
+    {
+        if(!diff.users.isEmpty())
+            insertUser(diff.users.takeFirst());
+        else
+        if(!diff.chats.isEmpty())
+            insertChat(diff.chats.takeFirst());
+        else
+        if(!diff.updates.isEmpty())
+            insertUpdate(diff.updates.takeFirst());
+        else
+        if(!diff.messages.isEmpty())
+        {
+            const Message m = diff.messages.takeFirst();
+            insertMessage(m);
+
+            if (!FLAG_TO_OUT(m.flags())) {
+                QDate messageDate = QDateTime::fromTime_t(m.date()).date();
+                if (today == messageDate) {
+                    diff.receivedMessageCount += 1;
+                }
             }
         }
-    }
-    Q_FOREACH( const SecretChatMessage & m, secretChatMessages )
-        insertSecretChatMessage(m, true);
+        else
+        if(!diff.secretChatMessages.isEmpty())
+            insertSecretChatMessage(diff.secretChatMessages.takeFirst(), true);
+        else
+        {
+            p->differenceApplier->stop();
+
+            p->state = diff.state;
+            const bool intermediate = diff.intermediate;
+            const qint32 receivedMessageCount = diff.receivedMessageCount;
+            diff = TelegramQmlDifference();
 
-    Q_EMIT messagesReceived(receivedMessageCount);
+            Q_EMIT messagesReceived(receivedMessageCount);
+
+            if(intermediate)
+                updatesGetDifference();
+            else
+                flushPendingUpdates();
+            return;
+        }
+    }
 }
 
 void TelegramQml::updatesGetState_slt(qint64 id, qint32 pts, qint32 qts, qint32 date, qint32 seq, qint32 unreadCount)
@@ -4195,6 +5082,8 @@ void TelegramQml::updatesGetState_slt(qint64 id, qint32 pts, qint32 qts, qint32
     p->state.setSeq(seq);
     p->state.setUnreadCount(unreadCount);
 
+    /*! A request sent before the state was fetched again is stale !*/
+    p->difference_request = 0;
     QTimer::singleShot(100, this, SLOT(updatesGetDifference()));
 }
 
@@ -4202,8 +5091,6 @@ void TelegramQml::uploadGetFile_slt(qint64 id, const StorageFileType &type, qint
 {
     FileLocationObject *obj = p->downloads.value(id);
     if( !obj )
-        return;
-    if( !TqObject::isValid(tqobject_cast(obj)) )
     {
         p->downloads.remove(id);
         return;
@@ -4251,12 +5138,17 @@ void TelegramQml::uploadGetFile_slt(qint64 id, const StorageFileType &type, qint
             if (download_file.right(sfx.length()) != sfx) {
                 QFile::rename(download_file, download_file+sfx);
                 download->setLocation(FILES_PRE_STR + download_file+sfx);
+                p->fileIndex.updateFile(download_file+sfx);
             } else {
                 download->setLocation(FILES_PRE_STR + download_file);
+                p->fileIndex.updateFile(download_file);
             }
         }
         else
+        {
             download->setLocation(FILES_PRE_STR + download_file);
+            p->fileIndex.updateFile(download_file);
+        }
 
         download->setFileId(0);
         p->downloads.remove(id);
@@ -4285,13 +5177,16 @@ void TelegramQml::uploadCancelFile_slt(qint64 fileId, bool cancelled)
         MessageObject *msgObj = p->uploads.take(fileId);
         qint64 msgId = msgObj->id();
 
-        insertToGarbeges(p->messages.value(msgId));
+        removeMessage(msgId);
         Q_EMIT messagesChanged(false);
     }
     else
     if( p->downloads.contains(fileId) )
     {
         FileLocationObject *locObj = p->downloads.take(fileId);
+        if(!locObj)
+            return;
+
         locObj->download()->setLocation(QString());
         locObj->download()->setFileId(0);
         locObj->download()->setMtime(0);
@@ -4313,7 +5208,7 @@ void TelegramQml::incomingAsemanMessage(const Message &msg, const Dialog &dialog
     insertMessage(msg);
     insertDialog(dialog);
 
-    Q_EMIT incomingMessage( p->messages.value(msg.id()) );
+    Q_EMIT incomingMessage( materializeMessage(msg.id()) );
 }
 
 void TelegramQml::insertDialog(const Dialog &d, bool encrypted, bool fromDb)
@@ -4327,7 +5222,7 @@ void TelegramQml::insertDialog(const Dialog &d, bool encrypted, bool fromDb)
 
         p->dialogs.insert(did, obj);
 
-        connect( obj, SIGNAL(unreadCountChanged()), SLOT(refreshUnreadCount()) );
+        connect( obj, SIGNAL(unreadCountChanged()), SLOT(dialogUnreadCountChanged()) );
     }
     else
     if(fromDb)
@@ -4348,7 +5243,7 @@ void TelegramQml::insertDialog(const Dialog &d, bool encrypted, bool fromDb)
 
     Q_EMIT dialogsChanged(fromDb);
 
-    refreshUnreadCount();
+    refreshDialogUnread(did);
 
     if(!fromDb)
         p->database->insertDialog(d, encrypted);
@@ -4356,6 +5251,8 @@ void TelegramQml::insertDialog(const Dialog &d, bool encrypted, bool fromDb)
 
 void TelegramQml::insertMessage(const Message &t_m, bool encrypted, bool fromDb, bool tempMsg)
 {
+    p->fetch_messages.tries.remove(t_m.id());
+
     Message m = t_m;
     if (m.message().isEmpty()
             && m.action().classType() == MessageAction::typeMessageActionEmpty
@@ -4363,46 +5260,75 @@ void TelegramQml::insertMessage(const Message &t_m, bool encrypted, bool fromDb,
         return;
     }
 
-    if(m.replyToMsgId() && !p->messages.contains(m.replyToMsgId()))
+    if(m.replyToMsgId() && !p->messages_store.contains(m.replyToMsgId()))
     {
-        if( requestReadMessage(m.replyToMsgId()) )
+        fetchMissing(p->fetch_messages, m.replyToMsgId());
+        if(!p->pending_replies.contains(m.replyToMsgId(), m.id()))
             p->pending_replies.insert(m.replyToMsgId(), m.id());
 
         m.setReplyToMsgId(0);
     }
 
-    MessageObject *obj = p->messages.value(m.id());
-    if( !obj )
+    if(!encrypted)
     {
-        obj = new MessageObject(m, this);
-        obj->setEncrypted(encrypted);
+        const qint32 source = tempMsg? 0 : m.id();
+        if(m.fromId() && !p->users.contains(m.fromId()))
+            fetchMissing(p->fetch_users, m.fromId(), source);
+        if(m.fwdFromId() && !p->users.contains(m.fwdFromId()))
+            fetchMissing(p->fetch_users, m.fwdFromId(), source);
+        if(m.toId().chatId() && !p->chats.contains(m.toId().chatId()))
+            fetchMissing(p->fetch_chats, m.toId().chatId(), source);
+    }
 
-        p->messages.insert(m.id(), obj);
+    const bool exists = p->messages_store.contains(m.id());
+    if(exists && fromDb && !encrypted)
+        return;
 
-        qint64 did = m.toId().chatId();
-        if( !did )
-            did = FLAG_TO_OUT(m.flags())? m.toId().userId() : m.fromId();
+    p->messages_store[m.id()] = m;
+    p->messages_dates.insert(m.id(), m.date());
+    if(encrypted)
+        p->encrypted_messages.insert(m.id());
+    else
+        p->encrypted_messages.remove(m.id());
 
-        QList<qint64> list = p->messages_list.value(did);
+    qint64 did = m.toId().chatId();
+    if( !did )
+        did = FLAG_TO_OUT(m.flags())? m.toId().userId() : m.fromId();
 
-        list << m.id();
+    if( !exists )
+    {
+        QList<qint64> &list = p->messages_list[did];
 
         telegramp_qml_tmp = p;
-        qStableSort( list.begin(), list.end(), checkMessageLessThan );
+        list.insert( qUpperBound(list.begin(), list.end(), m.id(), checkMessageLessThan), m.id() );
+
+        Q_FOREACH(TelegramMessagesModel *model, p->messagesModelsOfDialog.value(did))
+            model->insertMessageRow(m.id());
 
-        p->messages_list[did] = list;
+        if(!fromDb)
+            Q_EMIT messageInserted(m.id(), did);
     }
-    else
-    if(fromDb && !encrypted)
-        return;
-    else
+
+    MessageObject *obj = p->messages.value(m.id());
+    if( obj )
     {
         *obj = m;
         obj->setEncrypted(encrypted);
     }
 
+    if( exists )
+    {
+        Q_FOREACH(TelegramMessagesModel *model, p->messagesModelsOfDialog.value(did))
+            model->updateMessageRow(m.id());
+
+        Q_EMIT messageUpdated(m.id(), did);
+    }
+
     Q_EMIT messagesChanged(fromDb && !encrypted);
 
+    if(!exists && p->autoCleanUpMessages && messagesStoreFull() && !p->cleanUpTimer->isActive())
+        p->cleanUpTimer->start();
+
     if(!fromDb && !tempMsg)
         p->database->insertMessage(m, encrypted);
     if(encrypted)
@@ -4414,9 +5340,16 @@ void TelegramQml::insertMessage(const Message &t_m, bool encrypted, bool fromDb,
         const QList<qint64> &pends = p->pending_replies.values(m.id());
         Q_FOREACH(const qint64 msgId, pends)
         {
+            QHash<qint64,Message>::iterator i = p->messages_store.find(msgId);
+            if(i != p->messages_store.end())
+                i.value().setReplyToMsgId(m.id());
+
             MessageObject *msg = p->messages.value(msgId);
             if(msg)
                 msg->setReplyToMsgId(m.id());
+
+            Q_FOREACH(TelegramMessagesModel *model, p->messagesModelsOfDialog.value(messageDialogId(msgId)))
+                model->updateMessageRow(msgId);
         }
 
         p->pending_replies.remove(m.id());
@@ -4425,6 +5358,9 @@ void TelegramQml::insertMessage(const Message &t_m, bool encrypted, bool fromDb,
 
 void TelegramQml::insertUser(const User &u, bool fromDb)
 {
+    p->fetch_users.tries.remove(u.id());
+    p->fetch_users.sources.remove(u.id());
+
     bool become_online = false;
     UserObject *obj = p->users.value(u.id());
     if(!fromDb && obj && obj->status()->classType() == UserStatus::typeUserStatusOffline &&
@@ -4435,6 +5371,11 @@ void TelegramQml::insertUser(const User &u, bool fromDb)
     {
         obj = new UserObject(u, this);
         p->users.insert(u.id(), obj);
+        p->userSortKeys.remove(u.id());
+        p->userSearchKeys.remove(u.id());
+
+        /*! Whatever was shown for the unknown user is stale now !*/
+        Q_EMIT userRenamed(u.id());
 
 //        getFile(obj->photo()->photoSmall());
 
@@ -4447,13 +5388,25 @@ void TelegramQml::insertUser(const User &u, bool fromDb)
         }
 
         Q_FOREACH(const QString &key, userNameKeys)
+        {
             p->userNameIndexes.insertMulti(key.toLower(), u.id());
+            p->userNameKeys[u.id()] << key.toLower();
+        }
     }
     else
     if(fromDb)
         return;
     else
+    {
+        const bool renamed = obj->firstName() != u.firstName() || obj->lastName() != u.lastName();
         *obj = u;
+        if(renamed)
+        {
+            p->userSortKeys.remove(u.id());
+            p->userSearchKeys.remove(u.id());
+            Q_EMIT userRenamed(u.id());
+        }
+    }
 
     if(!fromDb && p->database)
         p->database->insertUser(u);
@@ -4468,6 +5421,9 @@ void TelegramQml::insertUser(const User &u, bool fromDb)
 
 void TelegramQml::insertChat(const Chat &c, bool fromDb)
 {
+    p->fetch_chats.tries.remove(c.id());
+    p->fetch_chats.sources.remove(c.id());
+
     ChatObject *obj = p->chats.value(c.id());
     if( !obj )
     {
@@ -4475,12 +5431,18 @@ void TelegramQml::insertChat(const Chat &c, bool fromDb)
         p->chats.insert(c.id(), obj);
 
 //        getFile(obj->photo()->photoSmall());
+        Q_EMIT chatRenamed(c.id());
     }
     else
     if(fromDb)
         return;
     else
+    {
+        const bool renamed = obj->title() != c.title();
         *obj = c;
+        if(renamed)
+            Q_EMIT chatRenamed(c.id());
+    }
 
     if(!fromDb)
         p->database->insertChat(c);
@@ -4488,6 +5450,32 @@ void TelegramQml::insertChat(const Chat &c, bool fromDb)
     Q_EMIT chatsChanged();
 }
 
+void TelegramQml::insertChatFull(const ChatFull &chatFull, bool fromDb)
+{
+    ChatFullObject *obj = p->chatfulls.value(chatFull.id());
+    if( !obj )
+    {
+        obj = new ChatFullObject(chatFull, this);
+        p->chatfulls.insert(chatFull.id(), obj);
+    }
+    else
+    if(fromDb)
+        return;
+    else
+        *obj = chatFull;
+
+    if(!fromDb)
+    {
+        p->chatfulls_updated[chatFull.id()] = QDateTime::currentDateTime().toTime_t();
+        p->database->insertChatFull(chatFull);
+    }
+
+    p->chatParticipantSets.remove(chatFull.id());
+
+    Q_EMIT chatFullsChanged();
+    Q_EMIT chatParticipantsChanged(chatFull.id());
+}
+
 void TelegramQml::insertStickerSet(const StickerSet &set, bool fromDb)
 {
     StickerSetObject *obj = p->stickerSets.value(set.id());
@@ -4507,6 +5495,10 @@ void TelegramQml::insertStickerSet(const StickerSet &set, bool fromDb)
 
 void TelegramQml::insertStickerPack(const StickerPack &pack, bool fromDb)
 {
+    QSet<qint64> &emoticonIndex = p->stickerEmoticons[normalizeEmoticon(pack.emoticon())];
+    Q_FOREACH(qint64 docId, pack.documents())
+        emoticonIndex.insert(docId);
+
     StickerPackObject *obj = p->stickerPacks.value(pack.emoticon());
     if( !obj )
     {
@@ -4522,6 +5514,16 @@ void TelegramQml::insertStickerPack(const StickerPack &pack, bool fromDb)
 
 void TelegramQml::insertDocument(const Document &doc, bool fromDb)
 {
+    Q_FOREACH(const DocumentAttribute &attr, doc.attributes())
+    {
+        if(attr.classType() != DocumentAttribute::typeDocumentAttributeSticker)
+            continue;
+
+        p->stickerDocumentSets[doc.id()] = attr.stickerset().id();
+        if(!attr.alt().isEmpty())
+            p->stickerEmoticons[normalizeEmoticon(attr.alt())].insert(doc.id());
+    }
+
     DocumentObject *obj = p->documents.value(doc.id());
     if( !obj )
     {
@@ -4542,12 +5544,125 @@ void TelegramQml::insertUpdates(const UpdatesType &updates)
     Q_FOREACH( const Chat & c, updates.chats() )
         insertChat(c);
     Q_FOREACH( const Update & u, updates.updates() )
-        insertUpdate(u);
+        queueUpdate(u);
 
-    insertUpdate(updates.update());
+    queueUpdate(updates.update());
     timerUpdateDialogs(500);
 }
 
+bool TelegramQml::acceptPts(qint32 pts, qint32 ptsCount)
+{
+    if(!pts || !p->state.pts())
+        return true;
+
+    const qint32 start = pts - ptsCount;
+    if(start < p->state.pts())
+        return false;
+    if(start > p->state.pts() || p->differenceApplier->isActive())
+    {
+        /*! There is a gap, let the difference bring it !*/
+        if(!p->updatesGapTimer->isActive())
+            p->updatesGapTimer->start();
+        return false;
+    }
+
+    p->state.setPts(pts);
+    return true;
+}
+
+void TelegramQml::queueUpdate(const Update &update)
+{
+    if(!update.pts() || !p->state.pts())
+    {
+        insertUpdate(update);
+        return;
+    }
+
+    p->pending_updates.insert(update.pts(), update);
+    flushPendingUpdates();
+}
+
+void TelegramQml::queueUpdatesBlock(const TelegramQmlUpdatesBlock &block)
+{
+    if(!block.seq || !p->state.seq())
+    {
+        applyUpdatesBlock(block);
+        return;
+    }
+
+    p->pending_blocks.insert(block.seqStart, block);
+    flushPendingUpdates();
+}
+
+void TelegramQml::applyUpdatesBlock(const TelegramQmlUpdatesBlock &block)
+{
+    Q_FOREACH( const User & u, block.users )
+        insertUser(u);
+    Q_FOREACH( const Chat & c, block.chats )
+        insertChat(c);
+    Q_FOREACH( const Update & u, block.updates )
+        queueUpdate(u);
+
+    if(block.seq)
+        p->state.setSeq(block.seq);
+    if(block.date)
+        p->state.setDate(block.date);
+}
+
+void TelegramQml::flushPendingUpdates()
+{
+    if(p->differenceApplier->isActive())
+        return;
+
+    while(!p->pending_updates.isEmpty())
+    {
+        QMap<qint32, Update>::iterator i = p->pending_updates.begin();
+        const Update update = i.value();
+        const qint32 start = i.key() - update.ptsCount();
+        if(start > p->state.pts())
+            break;
+
+        p->pending_updates.erase(i);
+        if(start < p->state.pts())
+            continue;
+
+        insertUpdate(update);
+        p->state.setPts(update.pts());
+    }
+
+    while(!p->pending_blocks.isEmpty())
+    {
+        QMap<qint32, TelegramQmlUpdatesBlock>::iterator i = p->pending_blocks.begin();
+        const TelegramQmlUpdatesBlock block = i.value();
+        if(block.seqStart > p->state.seq()+1)
+            break;
+
+        p->pending_blocks.erase(i);
+        if(block.seqStart <= p->state.seq())
+            continue;
+
+        applyUpdatesBlock(block);
+    }
+
+    if(p->pending_updates.isEmpty() && p->pending_blocks.isEmpty())
+        p->updatesGapTimer->stop();
+    else
+    if(!p->updatesGapTimer->isActive())
+        p->updatesGapTimer->start();
+}
+
+void TelegramQml::updatesGapTimeout()
+{
+    /*! A difference on its way or being applied covers the gap already !*/
+    if(p->difference_request || p->differenceApplier->isActive())
+    {
+        p->updatesGapTimer->start();
+        return;
+    }
+
+    updatesGetDifference();
+}
+
 void TelegramQml::insertUpdate(const Update &update)
 {
     UserObject *user = p->users.value(update.userId());
@@ -4616,7 +5731,7 @@ void TelegramQml::insertUpdate(const Update &update)
         if( !did )
             did = FLAG_TO_OUT(msg.flags())? msg.toId().userId() : msg.fromId();
 
-        insertToGarbeges(p->messages.value(old_msgId));
+        removeMessage(old_msgId);
         insertMessage(msg);
         timerUpdateDialogs(3000);
     }
@@ -4632,25 +5747,7 @@ void TelegramQml::insertUpdate(const Update &update)
         if( !user )
             return;
 
-        const QString & id_str = QString::number(user->id());
-        const QPair<qint64,qint64> & timer_pair = QPair<qint64,qint64>(chat->id(), user->id());
-        QStringList tusers = dlg->typingUsers();
-
-        if( tusers.contains(id_str) )
-        {
-            const int timer_id = p->typing_timers.key(timer_pair);
-            killTimer(timer_id);
-            p->typing_timers.remove(timer_id);
-        }
-        else
-        {
-            tusers << id_str;
-            dlg->setTypingUsers( tusers );
-            Q_EMIT userStartTyping(user->id(), chat->id());
-        }
-
-        int timer_id = startTimer(6000);
-        p->typing_timers.insert(timer_id, timer_pair);
+        insertTypingUser(chat->id(), user->id());
     }
         break;
 
@@ -4686,6 +5783,12 @@ void TelegramQml::insertUpdate(const Update &update)
     case Update::typeUpdateChatParticipantDelete:
         if(chat)
             chat->setParticipantsCount( chat->participantsCount()-1 );
+        p->chatfulls_updated.remove(update.chatId());
+        if(p->chatParticipantSets.contains(update.chatId()))
+        {
+            p->chatParticipantSets[update.chatId()].remove(update.userId());
+            Q_EMIT chatParticipantsChanged(update.chatId());
+        }
         break;
 
     case Update::typeUpdateNewAuthorization:
@@ -4694,6 +5797,12 @@ void TelegramQml::insertUpdate(const Update &update)
     case Update::typeUpdateChatParticipantAdd:
         if(chat)
             chat->setParticipantsCount( chat->participantsCount()+1 );
+        p->chatfulls_updated.remove(update.chatId());
+        if(p->chatParticipantSets.contains(update.chatId()))
+        {
+            p->chatParticipantSets[update.chatId()].insert(update.userId());
+            Q_EMIT chatParticipantsChanged(update.chatId());
+        }
         break;
 
     case Update::typeUpdateDcOptions:
@@ -4705,7 +5814,7 @@ void TelegramQml::insertUpdate(const Update &update)
         Q_FOREACH(quint64 msgId, messages)
         {
             p->database->deleteMessage(msgId);
-            insertToGarbeges(p->messages.value(msgId));
+            removeMessage(msgId);
 
             Q_EMIT messagesChanged(false);
         }
@@ -4722,24 +5831,7 @@ void TelegramQml::insertUpdate(const Update &update)
         if( !dlg )
             return;
 
-        const QString & id_str = QString::number(user->id());
-        const QPair<qint64,qint64> & timer_pair = QPair<qint64,qint64>(user->id(), user->id());
-        QStringList tusers = dlg->typingUsers();
-        if( tusers.contains(id_str) )
-        {
-            const int timer_id = p->typing_timers.key(timer_pair);
-            killTimer(timer_id);
-            p->typing_timers.remove(timer_id);
-        }
-        else
-        {
-            tusers << id_str;
-            dlg->setTypingUsers( tusers );
-            Q_EMIT userStartTyping(user->id(), user->id());
-        }
-
-        int timer_id = startTimer(6000);
-        p->typing_timers.insert(timer_id, timer_pair);
+        insertTypingUser(user->id(), user->id());
     }
         break;
 
@@ -4751,24 +5843,7 @@ void TelegramQml::insertUpdate(const Update &update)
 
         qint64 userId = update.chat().adminId()==me()? update.chat().participantId() : update.chat().adminId();
 
-        const QString & id_str = QString::number(userId);
-        const QPair<qint64,qint64> & timer_pair = QPair<qint64,qint64>(userId, userId);
-        QStringList tusers = dlg->typingUsers();
-        if( tusers.contains(id_str) )
-        {
-            const int timer_id = p->typing_timers.key(timer_pair);
-            killTimer(timer_id);
-            p->typing_timers.remove(timer_id);
-        }
-        else
-        {
-            tusers << id_str;
-            dlg->setTypingUsers( tusers );
-            Q_EMIT userStartTyping(userId, userId);
-        }
-
-        int timer_id = startTimer(6000);
-        p->typing_timers.insert(timer_id, timer_pair);
+        insertTypingUser(userId, userId);
     }
         break;
 
@@ -4798,6 +5873,7 @@ void TelegramQml::insertUpdate(const Update &update)
         break;
 
     case Update::typeUpdateChatParticipants:
+        p->chatfulls_updated.remove(update.participants().chatId());
         timerUpdateDialogs();
         break;
 
@@ -4810,6 +5886,10 @@ void TelegramQml::insertUpdate(const Update &update)
         Q_FOREACH(qint64 msg, msgs)
             if(msg <= maxId)
             {
+                QHash<qint64,Message>::iterator i = p->messages_store.find(msg);
+                if(i != p->messages_store.end())
+                    i.value().setFlags(i.value().flags() & ~0x1);
+
                 MessageObject *obj = p->messages.value(msg);
                 if(obj)
                     obj->setUnread(false);
@@ -4819,7 +5899,7 @@ void TelegramQml::insertUpdate(const Update &update)
     }
 }
 
-void TelegramQml::insertContact(const Contact &c, bool fromDb)
+void TelegramQml::insertContact(const Contact &c, bool fromDb, bool notify)
 {
     ContactObject *obj = p->contacts.value(c.userId());
     if( !obj )
@@ -4833,7 +5913,8 @@ void TelegramQml::insertContact(const Contact &c, bool fromDb)
     if(!fromDb)
         p->database->insertContact(c);
 
-    Q_EMIT contactsChanged();
+    if(notify)
+        Q_EMIT contactsChanged();
 }
 
 void TelegramQml::insertEncryptedMessage(const EncryptedMessage &e)
@@ -5048,7 +6129,10 @@ void TelegramQml::insertSecretChatMessage(const SecretChatMessage &sc, bool cach
 
     insertMessage(msg, true);
 
-    MessageObject *msgObj = p->messages.value(msg.id());
+    if(hasInternalMedia)
+        p->messages_media_keys[msg.id()] = QPair<QByteArray,QByteArray>(dmedia.key(), dmedia.iv());
+
+    MessageObject *msgObj = materializeMessage(msg.id());
     if(msgObj && hasInternalMedia)
     {
         msgObj->media()->setEncryptKey(dmedia.key());
@@ -5143,7 +6227,7 @@ void TelegramQml::deleteLocalHistory(qint64 peerId) {
         }
     } else {
         Q_FOREACH(qint64 msgId, messages) {
-            insertToGarbeges(p->messages.value(msgId));
+            removeMessage(msgId);
         }
     }
     Q_EMIT messagesChanged(false);
@@ -5163,18 +6247,23 @@ void TelegramQml::timerEvent(QTimerEvent *e)
 {
     if( e->timerId() == p->upd_dialogs_timer )
     {
-        if( p->telegram && p->telegram->isConnected() ) {
-            p->telegram->messagesGetDialogs(0,0,1000);
-        }
+        messagesGetDialogs();
 
         killTimer(p->upd_dialogs_timer);
         p->upd_dialogs_timer = 0;
     }
     else
+    if( e->timerId() == p->dialogs_sync_timer )
+    {
+        killTimer(p->dialogs_sync_timer);
+        p->dialogs_sync_timer = 0;
+
+        requestDialogsPage();
+    }
+    else
     if ( e->timerId() == p->update_contacts_timer)
     {
-        if ( p->telegram )
-            p->telegram->contactsGetContacts();
+        contactsGetContacts();
 
         killTimer(p->update_contacts_timer);
         p->update_contacts_timer = 0;
@@ -5189,20 +6278,77 @@ void TelegramQml::timerEvent(QTimerEvent *e)
         p->garbage_checker_timer = 0;
     }
     else
-    if( p->typing_timers.contains(e->timerId()) )
+    if( e->timerId() == p->typing_wheel_timer )
     {
-        killTimer(e->timerId());
+        /*! Expire every typing state of the next slot at once !*/
+        p->typing_wheel_pos = (p->typing_wheel_pos+1) % TYPING_WHEEL_SLOTS;
+        QSet< QPair<qint64,qint64> > expired;
+        expired.swap(p->typing_wheel[p->typing_wheel_pos]);
 
-        const QPair<qint64,qint64> & pair = p->typing_timers.take(e->timerId());
-        DialogObject *dlg = p->dialogs.value(pair.first);
-        if( !dlg )
-            return;
+        QSet<qint64> dialogs;
+        QSetIterator< QPair<qint64,qint64> > i(expired);
+        while(i.hasNext())
+        {
+            const QPair<qint64,qint64> &pair = i.next();
+            p->typing_slots.remove(pair);
+
+            QHash<qint64, QSet<qint64> >::iterator ti = p->typing_users.find(pair.first);
+            if(ti == p->typing_users.end())
+                continue;
+
+            ti.value().remove(pair.second);
+            if(ti.value().isEmpty())
+                p->typing_users.erase(ti);
+
+            dialogs.insert(pair.first);
+        }
+
+        Q_FOREACH(qint64 dId, dialogs)
+            refreshTypingUsers(dId);
+
+        if(p->typing_slots.isEmpty())
+        {
+            killTimer(p->typing_wheel_timer);
+            p->typing_wheel_timer = 0;
+        }
+    }
+}
 
-        QStringList typings = dlg->typingUsers();
-        typings.removeAll(QString::number(pair.second));
+void TelegramQml::insertTypingUser(qint64 dId, qint64 userId)
+{
+    const QPair<qint64,qint64> pair(dId, userId);
+    const int slot = (p->typing_wheel_pos + TYPING_WHEEL_SLOTS - 1) % TYPING_WHEEL_SLOTS;
 
-        dlg->setTypingUsers(typings);
+    QHash<QPair<qint64,qint64>, int>::iterator i = p->typing_slots.find(pair);
+    if(i != p->typing_slots.end())
+    {
+        p->typing_wheel[i.value()].remove(pair);
+        i.value() = slot;
+    }
+    else
+    {
+        p->typing_slots.insert(pair, slot);
+        p->typing_users[dId].insert(userId);
+        refreshTypingUsers(dId);
+        Q_EMIT userStartTyping(userId, dId);
     }
+
+    p->typing_wheel[slot].insert(pair);
+    if(!p->typing_wheel_timer)
+        p->typing_wheel_timer = startTimer(TYPING_WHEEL_TICK);
+}
+
+void TelegramQml::refreshTypingUsers(qint64 dId)
+{
+    DialogObject *dlg = p->dialogs.value(dId);
+    if( !dlg )
+        return;
+
+    QStringList typings;
+    Q_FOREACH(qint64 userId, p->typing_users.value(dId))
+        typings << QString::number(userId);
+
+    dlg->setTypingUsers(typings);
 }
 
 void TelegramQml::startGarbageChecker()
@@ -5224,7 +6370,15 @@ void TelegramQml::insertToGarbeges(QObject *obj)
         const qint64 dId = messageDialogId(mId);
 
         p->messages_list[dId].removeAll(mId);
+        p->messages_store.remove(mId);
+        p->messages_dates.remove(mId);
+        p->encrypted_messages.remove(mId);
+        p->messages_media_keys.remove(mId);
         p->messages.remove(mId);
+
+        Q_FOREACH(TelegramMessagesModel *model, p->messagesModelsOfDialog.value(dId))
+            model->removeMessageRow(mId);
+        forgetMessage(mId);
         p->uploads.remove(mId);
         p->pend_messages.remove(mId);
     }
@@ -5237,6 +6391,7 @@ void TelegramQml::insertToGarbeges(QObject *obj)
         p->dialogs.remove(dId);
         p->fakeDialogs.remove(dId);
         p->dialogs_list.removeAll(dId);
+        refreshDialogUnread(dId);
     }
     else
     if(qobject_cast<ChatObject*>(obj))
@@ -5253,6 +6408,8 @@ void TelegramQml::insertToGarbeges(QObject *obj)
         const qint32 userId = user->id();
 
         p->users.remove(userId);
+        p->userSortKeys.remove(userId);
+        p->userSearchKeys.remove(userId);
     }
 
     p->garbages.insert(obj);
@@ -5295,6 +6452,34 @@ void TelegramQml::dbDialogFounded(const Dialog &dialog, bool encrypted)
     }
 }
 
+void TelegramQml::dbChatFullFounded(const ChatFull &chatFull, qint64 updated)
+{
+    if(p->chatfulls.contains(chatFull.id()))
+        return;
+
+    p->chatfulls_updated[chatFull.id()] = updated;
+    insertChatFull(chatFull, true);
+}
+
+void TelegramQml::dbStickersFounded(const MessagesAllStickers &stickers)
+{
+    if(p->stickersLoaded)
+        return;
+
+    p->stickersLoaded = true;
+    if(!stickers.hash().isEmpty() && p->installedStickerSets.isEmpty())
+    {
+        insertAllStickers(stickers, true);
+        p->stickersHash = stickers.hash();
+    }
+
+    if(p->stickersRequested)
+    {
+        p->stickersRequested = false;
+        messagesGetAllStickers();
+    }
+}
+
 void TelegramQml::dbContactFounded(const Contact &contact)
 {
     insertContact(contact, true);
@@ -5310,8 +6495,19 @@ void TelegramQml::dbMessageFounded(const Message &message)
     insertMessage(message, encrypted, true);
 }
 
+void TelegramQml::dbValueFounded(const QString &key, const QString &value)
+{
+    if(key == DATABASE_CONTACTS_HASH_KEY)
+        p->contactsHash = value;
+}
+
 void TelegramQml::dbMediaKeysFounded(qint64 mediaId, const QByteArray &key, const QByteArray &iv)
 {
+    if(!p->messages_store.contains(mediaId))
+        return;
+
+    p->messages_media_keys[mediaId] = QPair<QByteArray,QByteArray>(key, iv);
+
     MessageObject *msg = p->messages.value(mediaId);
     if(!msg)
         return;
@@ -5322,21 +6518,64 @@ void TelegramQml::dbMediaKeysFounded(qint64 mediaId, const QByteArray &key, cons
 
 void TelegramQml::refreshUnreadCount()
 {
-    int unreadCount = 0;
-    Q_FOREACH( DialogObject *obj, p->dialogs )
+    p->dialogs_unread.clear();
+    p->unreadCount = 0;
+    p->unreadMutedCount = 0;
+    p->unreadFavoritesCount = 0;
+
+    Q_FOREACH( qint64 dId, p->dialogs.keys() )
+        refreshDialogUnread(dId);
+
+    Q_EMIT unreadCountChanged();
+    Q_EMIT unreadMutedCountChanged();
+    Q_EMIT unreadFavoritesCountChanged();
+}
+
+void TelegramQml::refreshDialogUnread(int dId)
+{
+    const TelegramQmlUnreadState old = p->dialogs_unread.value(dId);
+
+    TelegramQmlUnreadState state;
+    DialogObject *dlg = p->dialogs.value(dId);
+    if(dlg)
     {
-        int dId = obj->peer()->chatId()? obj->peer()->chatId() : obj->peer()->userId();
-        if(p->userdata && (p->userdata->notify(dId) & UserData::DisableBadges) )
-            continue;
+        state.count = dlg->unreadCount();
+        state.badges = !p->userdata || !(p->userdata->notify(dId) & UserData::DisableBadges);
+        state.muted = p->userdata && p->userdata->isMuted(dId);
+        state.favorited = p->userdata && p->userdata->isFavorited(dId);
+        p->dialogs_unread[dId] = state;
+    }
+    else
+        p->dialogs_unread.remove(dId);
+
+    const int total = (state.badges? state.count : 0) - (old.badges? old.count : 0);
+    const int muted = (state.muted? state.count : 0) - (old.muted? old.count : 0);
+    const int favorites = (state.favorited? state.count : 0) - (old.favorited? old.count : 0);
 
-        unreadCount += obj->unreadCount();
+    if(total)
+    {
+        p->unreadCount += total;
+        Q_EMIT unreadCountChanged();
+    }
+    if(muted)
+    {
+        p->unreadMutedCount += muted;
+        Q_EMIT unreadMutedCountChanged();
     }
+    if(favorites)
+    {
+        p->unreadFavoritesCount += favorites;
+        Q_EMIT unreadFavoritesCountChanged();
+    }
+}
 
-    if( p->unreadCount == unreadCount )
+void TelegramQml::dialogUnreadCountChanged()
+{
+    DialogObject *dlg = qobject_cast<DialogObject*>(sender());
+    if(!dlg)
         return;
 
-    p->unreadCount = unreadCount;
-    Q_EMIT unreadCountChanged();
+    refreshDialogUnread(dlg->peer()->chatId()? dlg->peer()->chatId() : dlg->peer()->userId());
 }
 
 void TelegramQml::refreshTotalUploadedPercent()
@@ -5395,11 +6634,11 @@ void TelegramQml::updateEncryptedTopMessage(const Message &message)
     if(!dlg)
         return;
 
-    MessageObject *topMessage = p->messages.value(dlg->topMessage());
-    if(dlg->topMessage() && !topMessage)
+    const qint64 topMessage = dlg->topMessage();
+    qint32 topMsgDate = topMessage? p->messages_dates.value(topMessage) : 0;
+    if(topMessage && !topMsgDate)
         return;
 
-    qint32 topMsgDate = topMessage? topMessage->date() : 0;
     if(message.date() < topMsgDate)
         return;
 
@@ -5483,14 +6722,16 @@ QStringList TelegramQml::stringToIndex(const QString &str)
 
 void TelegramQml::objectDestroyed(QObject *obj)
 {
-    if(qobject_cast<UploadObject*>(obj))
-    {
-        p->uploadPercents.remove( static_cast<UploadObject*>(obj) );
+    /*! obj is already demoted to QObject here, so qobject_cast can't be used !*/
+    if(p->uploadPercents.remove( static_cast<UploadObject*>(obj) ))
         refreshTotalUploadedPercent();
-    }
-    if(qobject_cast<FileLocationObject*>(obj))
+
+    /*! The QPointer is already null, so the hash is looked up by object !*/
+    QHash<QObject*, qint64>::iterator i = p->accessHashObjects.find(obj);
+    if(i != p->accessHashObjects.end())
     {
-        p->accessHashes.remove( static_cast<FileLocationObject>(obj).accessHash() );
+        p->accessHashes.remove(i.value());
+        p->accessHashObjects.erase(i);
     }
 }
 
@@ -5511,17 +6752,19 @@ bool checkDialogLessThan( qint64 a, qint64 b )
     if( !bo )
         return true;
 
-    MessageObject *am = telegramp_qml_tmp->messages.value(ao->topMessage());
-    MessageObject *bm = telegramp_qml_tmp->messages.value(bo->topMessage());
+    /*! A zero date means the top message isn't stored !*/
+    const TqFlatHash<qint32> &dates = telegramp_qml_tmp->messages_dates;
+    const qint32 am = dates.value(ao->topMessage());
+    const qint32 bm = dates.value(bo->topMessage());
     if(!am || !bm)
     {
         EncryptedChatObject *aec = telegramp_qml_tmp->encchats.value(a);
         EncryptedChatObject *bec = telegramp_qml_tmp->encchats.value(b);
         if(aec && bm)
-            return aec->date() > bm->date();
+            return aec->date() > bm;
         else
         if(am && bec)
-            return am->date() > bec->date();
+            return am > bec->date();
         else
         if(aec && bec)
             return aec->date() > bec->date();
@@ -5529,15 +6772,16 @@ bool checkDialogLessThan( qint64 a, qint64 b )
             return ao->topMessage() > bo->topMessage();
     }
 
-    return am->date() > bm->date();
+    return am > bm;
 }
 
 bool checkMessageLessThan( qint64 a, qint64 b )
 {
-    MessageObject *am = telegramp_qml_tmp->messages.value(a);
-    MessageObject *bm = telegramp_qml_tmp->messages.value(b);
+    const TqFlatHash<qint32> &dates = telegramp_qml_tmp->messages_dates;
+    const qint32 am = dates.value(a);
+    const qint32 bm = dates.value(b);
     if(am && bm)
-        return am->date() > bm->date();
+        return am > bm;
     else
         return a > b;
 }
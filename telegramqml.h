@@ -25,11 +25,14 @@
 
 #include <QObject>
 #include <QStringList>
+#include <QSet>
 #include <QUrl>
+#include <QCollator>
 
 #include <telegram/types/types.h>
 
 #include "telegramthumbnailer.h"
+#include "telegramfileindex.h"
 #include "telegramqml_global.h"
 #include "databaseabstractencryptor.h"
 
@@ -66,6 +69,8 @@ class StickerSetObject;
 class Telegram;
 class TelegramThumbnailer;
 class TelegramQmlPrivate;
+class TelegramQmlUpdatesBlock;
+class TelegramQmlFetchQueue;
 class TELEGRAMQMLSHARED_EXPORT TelegramQml : public QObject
 {
     Q_OBJECT
@@ -87,10 +92,14 @@ class TELEGRAMQMLSHARED_EXPORT TelegramQml : public QObject
     Q_PROPERTY(DatabaseAbstractEncryptor* encrypter READ encrypter WRITE setEncrypter NOTIFY encrypterChanged)
     Q_PROPERTY(bool autoAcceptEncrypted READ autoAcceptEncrypted WRITE setAutoAcceptEncrypted NOTIFY autoAcceptEncryptedChanged)
     Q_PROPERTY(bool autoCleanUpMessages READ autoCleanUpMessages WRITE setAutoCleanUpMessages NOTIFY autoCleanUpMessagesChanged)
+    Q_PROPERTY(int  messagesCacheLimit  READ messagesCacheLimit  WRITE setMessagesCacheLimit  NOTIFY messagesCacheLimitChanged)
+    Q_PROPERTY(int  messagesStoreLimit  READ messagesStoreLimit  WRITE setMessagesStoreLimit  NOTIFY messagesStoreLimitChanged)
     Q_PROPERTY(int  autoRewakeInterval  READ autoRewakeInterval  WRITE setAutoRewakeInterval  NOTIFY autoRewakeIntervalChanged)
 
     Q_PROPERTY(bool  online               READ online WRITE setOnline NOTIFY onlineChanged)
     Q_PROPERTY(int   unreadCount          READ unreadCount            NOTIFY unreadCountChanged)
+    Q_PROPERTY(int   unreadMutedCount     READ unreadMutedCount       NOTIFY unreadMutedCountChanged)
+    Q_PROPERTY(int   unreadFavoritesCount READ unreadFavoritesCount   NOTIFY unreadFavoritesCountChanged)
     Q_PROPERTY(qreal totalUploadedPercent READ totalUploadedPercent   NOTIFY totalUploadedPercentChanged)
 
     Q_PROPERTY(bool uploadingProfilePhoto READ uploadingProfilePhoto NOTIFY uploadingProfilePhotoChanged)
@@ -187,8 +196,19 @@ public:
     void setAutoCleanUpMessages(bool stt);
     bool autoCleanUpMessages() const;
 
+    void setMessagesCacheLimit(int limit);
+    int messagesCacheLimit() const;
+
+    void setMessagesStoreLimit(int limit);
+    int messagesStoreLimit() const;
+
+    void pinMessage(qint64 msgId);
+    void unpinMessage(qint64 msgId);
+
     void registerMessagesModel(TelegramMessagesModel *model);
     void unregisterMessagesModel(TelegramMessagesModel *model);
+    void setMessagesModelDialog(TelegramMessagesModel *model, qint64 dId);
+    bool messageLessThan(qint64 a, qint64 b) const;
 
     void registerSearchModel(TelegramSearchModel *model);
     void unregisterSearchModel(TelegramSearchModel *model);
@@ -210,6 +230,8 @@ public:
     int autoRewakeInterval() const;
 
     int unreadCount() const;
+    int unreadMutedCount() const;
+    int unreadFavoritesCount() const;
     qreal totalUploadedPercent() const;
 
     bool authNeeded() const;
@@ -244,6 +266,11 @@ public:
     Q_INVOKABLE MessageObject *message(qint64 id) const;
     Q_INVOKABLE ChatObject *chat(qint64 id) const;
     Q_INVOKABLE UserObject *user(qint64 id) const;
+    QCollatorSortKey userSortKey(qint64 id) const;
+    QString userSearchKey(qint64 id) const;
+    Q_INVOKABLE QString userDisplayName(qint64 id) const;
+    static QString normalizeName(const QString &name);
+    TelegramFileIndex *fileIndex() const;
     Q_INVOKABLE qint64 messageDialogId(qint64 id) const;
     Q_INVOKABLE DialogObject *messageDialog(qint64 id) const;
     Q_INVOKABLE WallPaperObject *wallpaper(qint64 id) const;
@@ -298,12 +325,16 @@ public:
     QList<qint64> stickerSets() const;
     QList<qint64> stickerSetDocuments(qint64 id) const;
     QList<qint64> stickerSetDocuments(const QString &shortName) const;
+    QList<qint64> stickersOfEmoticon(const QString &emoticon) const;
+    static QString normalizeEmoticon(const QString &emoticon);
 
     InputUser getInputUser(qint64 userId) const;
     InputPeer getInputPeer(qint64 pid);
     qint64 generateRandomId() const;
 
     QList<qint64> userIndex(const QString &keyword);
+    QList<qint64> userIndex(const QString &keyword, const QSet<qint64> &scope, int limit);
+    QSet<qint64> chatParticipants(qint64 chatId) const;
 
 public Q_SLOTS:
     void authLogout();
@@ -351,14 +382,18 @@ public Q_SLOTS:
     void messagesAcceptEncryptedChat(qint32 chatId);
     qint64 messagesDiscardEncryptedChat(qint32 chatId, bool force = false);
 
-    void messagesGetFullChat(qint32 chatId);
+    void contactsGetContacts();
+    void messagesGetDialogs();
+    void messagesGetFullChat(qint32 chatId, bool force = false);
 
     void installStickerSet(const QString &shortName);
     void uninstallStickerSet(const QString &shortName);
+    void messagesGetAllStickers();
     void getStickerSet(const QString &shortName);
     void getStickerSet(DocumentObject *doc);
 
     void search(const QString &keyword);
+    qint64 searchMessages(const QString &keyword, qint64 peerId = 0, qint32 maxId = 0, int limit = 50);
     void searchContact(const QString &keyword);
 
     qint64 sendFile(qint64 dialogId, const QString & file , bool forceDocument = false, bool forceAudio = false);
@@ -394,6 +429,8 @@ Q_SIGNALS:
     void telegramChanged();
     void autoAcceptEncryptedChanged();
     void autoCleanUpMessagesChanged();
+    void messagesCacheLimitChanged();
+    void messagesStoreLimitChanged();
     void userDataChanged();
     void databaseChanged();
     void onlineChanged();
@@ -401,12 +438,16 @@ Q_SIGNALS:
     void tempPathChanged();
     void dialogsChanged(bool cachedData);
     void messagesChanged(bool cachedData);
+    void messageInserted(qint64 msgId, qint64 dId);
+    void messageUpdated(qint64 msgId, qint64 dId);
     void usersChanged();
     void chatsChanged();
+    void chatRenamed(qint64 chatId);
     void wallpapersChanged();
     void autoRewakeIntervalChanged();
     void uploadsChanged();
     void chatFullsChanged();
+    void chatParticipantsChanged(qint64 chatId);
     void contactsChanged();
     void autoUpdateChanged();
     void encryptedChatsChanged();
@@ -420,6 +461,8 @@ Q_SIGNALS:
     void documentStickerRecieved(DocumentObject *document, StickerSetObject *set);
 
     void unreadCountChanged();
+    void unreadMutedCountChanged();
+    void unreadFavoritesCountChanged();
     void totalUploadedPercentChanged();
     void invisibleChanged();
 
@@ -446,6 +489,7 @@ Q_SIGNALS:
     void accountDeviceUnregistered(bool ok);
 
     void userBecomeOnline(qint64 userId);
+    void userRenamed(qint64 userId);
     void userStartTyping(qint64 userId, qint64 dId);
     void userBlocked(qint64 userId);
     void userUnblocked(qint64 userId);
@@ -463,6 +507,7 @@ Q_SIGNALS:
     void incomingEncryptedMessage( EncryptedMessageObject *msg );
 
     void searchDone(const QList<qint64> &messages);
+    void messagesSearched(qint64 reqId, const QList<qint64> &messages);
     void contactsFounded(const QList<qint32> &contacts);
 
     void messageSent(qint32 reqId, MessageObject *msg);
@@ -561,6 +606,8 @@ private Q_SLOTS:
     void updateSecretChatMessage_slt(const SecretChatMessage &secretChatMessage, qint32 qts);
     void updatesGetDifference_slt(qint64 id, const QList<Message> &messages, const QList<SecretChatMessage> &secretChatMessages, const QList<Update> &otherUpdates, const QList<Chat> &chats, const QList<User> &users, const UpdatesState &state, bool isIntermediateState);
     void updatesGetState_slt(qint64 id, qint32 pts, qint32 qts, qint32 date, qint32 seq, qint32 unreadCount);
+    void applyDifferenceSlice();
+    void updatesGapTimeout();
 
     void uploadGetFile_slt(qint64 id, const StorageFileType & type, qint32 mtime, const QByteArray & bytes, qint32 partId, qint32 downloaded, qint32 total);
     void uploadSendFile_slt(qint64 fileId, qint32 partId, qint32 uploaded, qint32 totalSize);
@@ -575,12 +622,20 @@ private:
     void insertMessage(const Message & message , bool encrypted = false, bool fromDb = false, bool tempMsg = false);
     void insertUser( const User & user, bool fromDb = false );
     void insertChat( const Chat & chat, bool fromDb = false );
+    void insertChatFull(const ChatFull &chatFull, bool fromDb = false);
+    void insertAllStickers(const MessagesAllStickers &stickers, bool fromDb = false);
     void insertStickerSet(const StickerSet &set, bool fromDb = false);
     void insertStickerPack(const StickerPack &pack, bool fromDb = false);
     void insertDocument(const Document &doc, bool fromDb = false);
     void insertUpdates(const UpdatesType &updates);
+    void requestDialogsPage();
     void insertUpdate( const Update & update );
-    void insertContact(const Contact & contact , bool fromDb = false);
+    bool acceptPts(qint32 pts, qint32 ptsCount);
+    void queueUpdate(const Update &update);
+    void queueUpdatesBlock(const TelegramQmlUpdatesBlock &block);
+    void applyUpdatesBlock(const TelegramQmlUpdatesBlock &block);
+    void flushPendingUpdates();
+    void insertContact(const Contact & contact , bool fromDb = false, bool notify = true);
     void insertEncryptedMessage(const EncryptedMessage & emsg);
     void insertEncryptedChat(const EncryptedChat & c);
     void insertSecretChatMessage(const SecretChatMessage & sc, bool cachedMsg = false);
@@ -604,15 +659,23 @@ protected:
     void startGarbageChecker();
     void insertToGarbeges(QObject *obj);
 
+    void insertTypingUser(qint64 dId, qint64 userId);
+    void refreshTypingUsers(qint64 dId);
+
 private Q_SLOTS:
     void dbUserFounded(const User &user);
     void dbChatFounded(const Chat &chat);
     void dbDialogFounded(const Dialog &dialog, bool encrypted);
     void dbContactFounded(const Contact &contact);
+    void dbChatFullFounded(const ChatFull &chatFull, qint64 updated);
+    void dbStickersFounded(const MessagesAllStickers &stickers);
     void dbMessageFounded(const Message &message);
     void dbMediaKeysFounded(qint64 mediaId, const QByteArray &key, const QByteArray &iv);
+    void dbValueFounded(const QString &key, const QString &value);
 
     void refreshUnreadCount();
+    void refreshDialogUnread(int dId);
+    void dialogUnreadCountChanged();
     void refreshTotalUploadedPercent();
     void refreshSecretChats();
     void updateEncryptedTopMessage(const Message &message);
@@ -625,9 +688,19 @@ private Q_SLOTS:
 
     void objectDestroyed(QObject *obj);
     void cleanUpMessages_prv();
-
-    bool requestReadMessage(qint32 msgId);
-    void requestReadMessage_prv();
+    void touchMessage(qint64 msgId) const;
+    void forgetMessage(qint64 msgId);
+    bool messagesCacheFull() const;
+    bool messagesStoreFull() const;
+    void cleanUpMessagesStore_prv();
+    MessageObject *materializeMessage(qint64 msgId) const;
+    void removeMessage(qint64 msgId);
+
+    bool fetchMissing(TelegramQmlFetchQueue &queue, qint32 id, qint32 source = 0);
+    void fetchMissing_prv();
+    void dbMissingFetched(const QList<qint32> &messages, const QList<qint32> &users, const QList<qint32> &chats);
+    void sendFetchRequests();
+    void fetchRetry_prv();
 
     static void removeFiles(const QString &dir);
 
@@ -53,6 +53,9 @@ SOURCES += \
     $$PWD/telegrammessagesmodel.cpp \
     $$PWD/telegramthumbnailer.cpp \
     $$PWD/telegramthumbnailercore.cpp \
+    $$PWD/telegramfileindex.cpp \
+    $$PWD/telegramfileindexcore.cpp \
+    $$PWD/telegrammediagallerymodel.cpp \
     $$PWD/newsletterdialog.cpp \
     $$PWD/userdata.cpp \
     $$PWD/telegramqmlinitializer.cpp \
@@ -88,12 +91,16 @@ HEADERS += \
     $$PWD/telegrammessagesmodel.h \
     $$PWD/telegramthumbnailer.h \
     $$PWD/telegramthumbnailercore.h \
+    $$PWD/telegramfileindex.h \
+    $$PWD/telegramfileindexcore.h \
+    $$PWD/telegrammediagallerymodel.h \
     $$PWD/objects/types.h \
     $$PWD/telegramqml_macros.h \
     $$PWD/telegramqml_global.h \
     $$PWD/newsletterdialog.h \
     $$PWD/telegramqmlinitializer.h \
     $$PWD/tqobject.h \
+    $$PWD/tqflathash.h \
     $$PWD/stickersmodel.h \
     $$PWD/documentattributelist.h \
     $$PWD/tgabstractlistmodel.h \
@@ -11,6 +11,8 @@
 
 #define DATABASE_DB_CONNECTION "database_connection"
 #define DATABASE_DB_PATH ":/database/database.sqlite"
+#define DATABASE_CONTACTS_HASH_KEY "contactsHash"
+#define DATABASE_STICKERS_HASH_KEY "stickersHash"
 
 #define CHECK_QUERY_ERROR(QUERY_OBJECT) \
     if(QUERY_OBJECT.lastError().isValid()) \
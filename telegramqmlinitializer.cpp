@@ -20,6 +20,7 @@
 #include "telegramdialogsmodel.h"
 #include "telegramfilehandler.h"
 #include "telegrammessagesmodel.h"
+#include "telegrammediagallerymodel.h"
 #include "stickersmodel.h"
 #include "objects/types.h"
 
@@ -58,6 +59,7 @@ void TelegramQmlInitializer::init(const char *uri)
     qmlRegisterType<TelegramDialogsModel>(uri, 1, 0, "DialogsModel");
     qmlRegisterType<TelegramFileHandler>(uri, 1, 0, "FileHandler");
     qmlRegisterType<TelegramMessagesModel>(uri, 1, 0, "MessagesModel");
+    qmlRegisterType<TelegramMediaGalleryModel>(uri, 1, 0, "MediaGalleryModel");
     qmlRegisterUncreatableType<UserData>(uri, 1, 0, "UserData", "");
 
     initializeTypes(uri);
@@ -1,20 +1,43 @@
+#define SEARCH_STEP_COUNT 50
+#define SEARCH_MIN_DELAY 150
+#define SEARCH_MAX_DELAY 800
+#define SEARCH_DELAY_STEP 150
+
 #include "telegramsearchmodel.h"
 #include "telegramqml.h"
+#include "database.h"
 #include "objects/types.h"
 
 #include <QTimerEvent>
 #include <QPointer>
+#include <QSet>
 
 class TelegramSearchModelPrivate
 {
 public:
     QPointer<TelegramQml> telegram;
+    QPointer<DialogObject> dialog;
     QString keyword;
 
+    /*! Keyword that the rows and the requests in flight belong to !*/
+    QString query;
+    int stepCount;
+
     bool initializing;
     int refresh_timer;
 
     QList<qint64> messages;
+    QSet<qint64> found;
+
+    /*! Local (database) and remote results are paged independently,
+     *  each one going down from the smallest id it returned. !*/
+    qint64 local_maxId;
+    bool local_pending;
+    bool local_done;
+
+    qint64 remote_request;
+    qint32 remote_maxId;
+    bool remote_done;
 };
 
 TelegramSearchModel::TelegramSearchModel(QObject *parent) :
@@ -24,6 +47,13 @@ TelegramSearchModel::TelegramSearchModel(QObject *parent) :
     p->refresh_timer = 0;
     p->telegram = 0;
     p->initializing = false;
+    p->stepCount = SEARCH_STEP_COUNT;
+    p->local_maxId = 0;
+    p->local_pending = false;
+    p->local_done = false;
+    p->remote_request = 0;
+    p->remote_maxId = 0;
+    p->remote_done = false;
 }
 
 TelegramQml *TelegramSearchModel::telegram() const
@@ -37,26 +67,38 @@ void TelegramSearchModel::setTelegram(TelegramQml *tgo)
     if( p->telegram == tg )
         return;
 
-    if( !tg && p->telegram )
+    if(p->telegram)
     {
-        disconnect( p->telegram, SIGNAL(searchDone(QList<qint64>)) , this, SLOT(searchDone(QList<qint64>)) );
-    }
+        disconnect( p->telegram, SIGNAL(messagesSearched(qint64,QList<qint64>)), this, SLOT(remoteSearched(qint64,QList<qint64>)) );
+        disconnect( p->telegram->database(), SIGNAL(messagesSearched(Peer,QString,qint64,QList<qint32>)),
+                    this, SLOT(localSearched(Peer,QString,qint64,QList<qint32>)) );
+
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->unpinMessage(msgId);
 
-    if(p->telegram)
         p->telegram->unregisterSearchModel(this);
+    }
 
     p->telegram = tg;
     if(p->telegram)
+    {
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->pinMessage(msgId);
+
         p->telegram->registerSearchModel(this);
+    }
 
     Q_EMIT telegramChanged();
 
-    p->initializing = false;
-    Q_EMIT initializingChanged();
+    setInitializing(false);
     if( !p->telegram )
         return;
 
-    connect( p->telegram, SIGNAL(searchDone(QList<qint64>)) , this, SLOT(searchDone(QList<qint64>)) );
+    connect( p->telegram, SIGNAL(messagesSearched(qint64,QList<qint64>)), this, SLOT(remoteSearched(qint64,QList<qint64>)) );
+    connect( p->telegram->database(), SIGNAL(messagesSearched(Peer,QString,qint64,QList<qint32>)),
+             this, SLOT(localSearched(Peer,QString,qint64,QList<qint32>)) );
+
+    p->query.clear();
     refresh();
 }
 
@@ -75,6 +117,37 @@ QString TelegramSearchModel::keyword() const
     return p->keyword;
 }
 
+DialogObject *TelegramSearchModel::dialog() const
+{
+    return p->dialog;
+}
+
+void TelegramSearchModel::setDialog(DialogObject *dlg)
+{
+    if(p->dialog == dlg)
+        return;
+
+    p->dialog = dlg;
+    Q_EMIT dialogChanged();
+
+    p->query.clear();
+    refresh();
+}
+
+void TelegramSearchModel::setStepCount(int step)
+{
+    if(p->stepCount == step)
+        return;
+
+    p->stepCount = qMax(1, step);
+    Q_EMIT stepCountChanged();
+}
+
+int TelegramSearchModel::stepCount() const
+{
+    return p->stepCount;
+}
+
 qint64 TelegramSearchModel::id(const QModelIndex &index) const
 {
     int row = index.row();
@@ -122,81 +195,243 @@ bool TelegramSearchModel::initializing() const
     return p->initializing;
 }
 
+bool TelegramSearchModel::complete() const
+{
+    return p->local_done && p->remote_done;
+}
+
 QList<qint64> TelegramSearchModel::messages() const
 {
     return p->messages;
 }
 
+/*! Answers of the previous keyword are dropped from here on. Rows that
+ *  still match a refined keyword stay, the rest are cleared right away;
+ *  the new query is sent once typing settles, sooner for longer
+ *  keywords since they are more selective. !*/
 void TelegramSearchModel::refresh()
 {
-    searchDone(QList<qint64>());
-
     if(p->refresh_timer)
         killTimer(p->refresh_timer);
 
     p->refresh_timer = 0;
-    if(!p->telegram)
+    p->local_pending = false;
+    p->remote_request = 0;
+
+    if(!p->telegram || p->keyword.isEmpty())
+    {
+        p->query.clear();
+        clear();
+        setInitializing(false);
         return;
+    }
+
+    if(!p->query.isEmpty() && p->keyword.contains(p->query, Qt::CaseInsensitive))
+        prune(p->keyword);
+    else
+        clear();
 
-    p->refresh_timer = startTimer(1000);
+    p->query = p->keyword;
+
+    const int delay = qMax(SEARCH_MIN_DELAY, SEARCH_MAX_DELAY - SEARCH_DELAY_STEP*(p->keyword.length()-1));
+    p->refresh_timer = startTimer(delay);
+    setInitializing(true);
 }
 
-void TelegramSearchModel::searchDone(const QList<qint64> &messages)
+void TelegramSearchModel::loadMore()
 {
-    p->initializing = false;
-    Q_EMIT initializingChanged();
+    if(p->refresh_timer || p->query.isEmpty())
+        return;
+
+    requestPage();
+}
+
+void TelegramSearchModel::requestPage()
+{
+    if(!p->telegram)
+        return;
 
-    for( int i=0 ; i<p->messages.count() ; i++ )
+    if(!p->local_done && !p->local_pending)
     {
-        const qint64 dId = p->messages.at(i);
-        if( messages.contains(dId) )
-            continue;
+        p->local_pending = true;
+        p->telegram->database()->searchMessages(scope(), p->query, p->local_maxId, p->stepCount);
+    }
+
+    /*! Secret chats live only on this device !*/
+    if(p->dialog && p->dialog->encrypted())
+        p->remote_done = true;
+
+    if(!p->remote_done && !p->remote_request && p->telegram->connected())
+    {
+        qint64 peerId = 0;
+        if(p->dialog)
+            peerId = p->dialog->peer()->classType()==Peer::typePeerChat? p->dialog->peer()->chatId() : p->dialog->peer()->userId();
+
+        p->remote_request = p->telegram->searchMessages(p->query, peerId, p->remote_maxId, p->stepCount);
+    }
+
+    setInitializing(p->local_pending || p->remote_request);
+}
+
+void TelegramSearchModel::localSearched(const Peer &peer, const QString &keyword, qint64 maxId, const QList<qint32> &messages)
+{
+    if(!p->local_pending || keyword != p->query || maxId != p->local_maxId)
+        return;
+
+    const Peer &current = scope();
+    if(peer.classType() != current.classType() || peer.chatId() != current.chatId() || peer.userId() != current.userId())
+        return;
+
+    p->local_pending = false;
+
+    QList<qint64> list;
+    Q_FOREACH(qint32 msgId, messages)
+        list << msgId;
 
-        beginRemoveRows(QModelIndex(), i, i);
-        p->messages.removeAt(i);
-        i--;
-        endRemoveRows();
+    merge(list);
+
+    if(messages.count() < p->stepCount)
+    {
+        p->local_done = true;
+        Q_EMIT completeChanged();
     }
+    else
+        p->local_maxId = messages.last();
+
+    setInitializing(p->local_pending || p->remote_request);
+}
+
+void TelegramSearchModel::remoteSearched(qint64 reqId, const QList<qint64> &messages)
+{
+    if(!reqId || reqId != p->remote_request)
+        return;
 
+    p->remote_request = 0;
+    merge(messages);
 
-    QList<qint64> temp_msgs = messages;
-    for( int i=0 ; i<temp_msgs.count() ; i++ )
+    if(messages.count() < p->stepCount)
     {
-        const qint64 dId = temp_msgs.at(i);
-        if( p->messages.contains(dId) )
-            continue;
+        p->remote_done = true;
+        Q_EMIT completeChanged();
+    }
+    else
+    {
+        qint64 minId = messages.first();
+        Q_FOREACH(qint64 msgId, messages)
+            minId = qMin(minId, msgId);
 
-        temp_msgs.removeAt(i);
-        i--;
+        p->remote_maxId = minId;
     }
-    while( p->messages != temp_msgs )
-        for( int i=0 ; i<p->messages.count() ; i++ )
-        {
-            const qint64 dId = p->messages.at(i);
-            int nw = temp_msgs.indexOf(dId);
-            if( i == nw )
-                continue;
 
-            beginMoveRows( QModelIndex(), i, i, QModelIndex(), nw>i?nw+1:nw );
-            p->messages.move( i, nw );
-            endMoveRows();
-        }
+    setInitializing(p->local_pending || p->remote_request);
+}
 
+/*! Streams a page into the rows, skipping messages that the other source
+ *  already delivered !*/
+void TelegramSearchModel::merge(const QList<qint64> &messages)
+{
+    if(!p->telegram)
+        return;
 
-    for( int i=0 ; i<messages.count() ; i++ )
+    TelegramQml *tg = p->telegram;
+    bool changed = false;
+    Q_FOREACH(qint64 msgId, messages)
     {
-        const qint64 dId = messages.at(i);
-        if( p->messages.contains(dId) )
+        if(p->found.contains(msgId))
             continue;
 
-        beginInsertRows(QModelIndex(), i, i );
-        p->messages.insert( i, dId );
+        p->found.insert(msgId);
+
+        QList<qint64>::iterator i = qUpperBound(p->messages.begin(), p->messages.end(), msgId, [tg](qint64 a, qint64 b){
+            return tg->messageLessThan(a, b);
+        });
+        const int row = i - p->messages.begin();
+
+        beginInsertRows(QModelIndex(), row, row);
+        p->messages.insert(row, msgId);
+        tg->pinMessage(msgId);
         endInsertRows();
+        changed = true;
+    }
+
+    if(changed)
+        Q_EMIT countChanged();
+}
+
+void TelegramSearchModel::prune(const QString &keyword)
+{
+    QList<qint64> list;
+    Q_FOREACH(qint64 msgId, p->messages)
+        if(p->telegram->message(msgId)->message().contains(keyword, Qt::CaseInsensitive))
+            list << msgId;
+
+    if(list.count() == p->messages.count())
+        return;
+
+    QList<qint64> removed;
+    syncList(p->messages, list, &removed);
+
+    Q_FOREACH(qint64 msgId, removed)
+    {
+        p->telegram->unpinMessage(msgId);
+        p->found.remove(msgId);
     }
 
     Q_EMIT countChanged();
 }
 
+void TelegramSearchModel::clear()
+{
+    const bool wasComplete = complete();
+    p->local_maxId = 0;
+    p->local_done = false;
+    p->remote_maxId = 0;
+    p->remote_done = false;
+    if(wasComplete)
+        Q_EMIT completeChanged();
+
+    p->found.clear();
+    if(p->messages.isEmpty())
+        return;
+
+    beginResetModel();
+    if(p->telegram)
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->unpinMessage(msgId);
+    p->messages.clear();
+    endResetModel();
+
+    Q_EMIT countChanged();
+}
+
+void TelegramSearchModel::setInitializing(bool stt)
+{
+    if(p->initializing == stt)
+        return;
+
+    p->initializing = stt;
+    Q_EMIT initializingChanged();
+}
+
+/*! A peer without ids makes the database search all dialogs !*/
+Peer TelegramSearchModel::scope() const
+{
+    if(!p->dialog)
+        return Peer(Peer::typePeerUser);
+
+    if(p->dialog->encrypted())
+    {
+        Peer peer(Peer::typePeerChat);
+        peer.setChatId(p->dialog->peer()->userId());
+        return peer;
+    }
+
+    Peer peer( static_cast<Peer::PeerType>(p->dialog->peer()->classType()) );
+    peer.setChatId(p->dialog->peer()->chatId());
+    peer.setUserId(p->dialog->peer()->userId());
+    return peer;
+}
+
 void TelegramSearchModel::timerEvent(QTimerEvent *e)
 {
     if(e->timerId() == p->refresh_timer)
@@ -204,25 +439,28 @@ void TelegramSearchModel::timerEvent(QTimerEvent *e)
         killTimer(p->refresh_timer);
         p->refresh_timer = 0;
 
-        if(!p->keyword.isEmpty())
-        {
-            p->initializing = true;
-            Q_EMIT initializingChanged();
-            p->telegram->search(p->keyword);
-        }
-        else
-        {
-            p->initializing = false;
-            Q_EMIT initializingChanged();
-        }
+        /*! Rows kept by prune() stay; the new query pages from the top !*/
+        const bool wasComplete = complete();
+        p->local_maxId = 0;
+        p->local_done = false;
+        p->remote_maxId = 0;
+        p->remote_done = false;
+        if(wasComplete)
+            Q_EMIT completeChanged();
+
+        requestPage();
     }
 }
 
 TelegramSearchModel::~TelegramSearchModel()
 {
     if(p->telegram)
+    {
+        Q_FOREACH(qint64 msgId, p->messages)
+            p->telegram->unpinMessage(msgId);
+
         p->telegram->unregisterSearchModel(this);
+    }
 
     delete p;
 }
-
@@ -5,6 +5,8 @@
 #include "tgabstractlistmodel.h"
 
 class MessageObject;
+class DialogObject;
+class Peer;
 class TelegramQml;
 class TelegramSearchModelPrivate;
 class TELEGRAMQMLSHARED_EXPORT TelegramSearchModel : public TgAbstractListModel
@@ -16,6 +18,9 @@ class TELEGRAMQMLSHARED_EXPORT TelegramSearchModel : public TgAbstractListModel
     Q_PROPERTY(int count READ count NOTIFY countChanged)
     Q_PROPERTY(bool initializing READ initializing NOTIFY initializingChanged)
     Q_PROPERTY(QString keyword READ keyword WRITE setKeyword NOTIFY keywordChanged)
+    Q_PROPERTY(DialogObject* dialog READ dialog WRITE setDialog NOTIFY dialogChanged)
+    Q_PROPERTY(int stepCount READ stepCount WRITE setStepCount NOTIFY stepCountChanged)
+    Q_PROPERTY(bool complete READ complete NOTIFY completeChanged)
 
 public:
     enum SearchsRoles {
@@ -31,6 +36,12 @@ public:
     void setKeyword(const QString &kw);
     QString keyword() const;
 
+    DialogObject *dialog() const;
+    void setDialog(DialogObject *dlg);
+
+    void setStepCount(int step);
+    int stepCount() const;
+
     qint64 id( const QModelIndex &index ) const;
     int rowCount(const QModelIndex & parent = QModelIndex()) const;
 
@@ -40,24 +51,38 @@ public:
 
     int count() const;
     bool initializing() const;
+    bool complete() const;
 
     QList<qint64> messages() const;
 
 public Q_SLOTS:
     void refresh();
+    void loadMore();
 
 Q_SIGNALS:
     void telegramChanged();
     void countChanged();
     void initializingChanged();
     void keywordChanged();
+    void dialogChanged();
+    void stepCountChanged();
+    void completeChanged();
 
 private Q_SLOTS:
-    void searchDone(const QList<qint64> &messages);
+    void localSearched(const Peer &peer, const QString &keyword, qint64 maxId, const QList<qint32> &messages);
+    void remoteSearched(qint64 reqId, const QList<qint64> &messages);
 
 protected:
     void timerEvent(QTimerEvent *e);
 
+private:
+    void requestPage();
+    void merge(const QList<qint64> &messages);
+    void prune(const QString &keyword);
+    void clear();
+    void setInitializing(bool stt);
+    Peer scope() const;
+
 private:
     TelegramSearchModelPrivate *p;
 };
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = tst_tqflathash
+QT += testlib
+QT -= gui
+CONFIG += testcase console no_keywords c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+HEADERS += \
+    ../../tqflathash.h
+
+SOURCES += \
+    tst_tqflathash.cpp
@@ -0,0 +1,462 @@
+#include "tqflathash.h"
+
+#include <QtTest>
+#include <QHash>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+/*! Stands in for the raw Message values of the store: the comparators
+ *  only read the date, the rest is what a node based lookup drags along !*/
+struct TstMessage
+{
+    TstMessage(): date(0) {}
+    qint32 date;
+    QString text;
+    QByteArray payload;
+};
+
+static const QHash<qint64,TstMessage> *tst_store = 0;
+static const TqFlatHash<qint32> *tst_dates = 0;
+static const QHash<qint64,qint64> *tst_topMessages = 0;
+
+/*! Same ordering as checkDialogLessThan, once through the store and once
+ *  through the date projection !*/
+static bool storeDialogLessThan(qint64 a, qint64 b)
+{
+    const qint64 at = tst_topMessages->value(a);
+    const qint64 bt = tst_topMessages->value(b);
+    const qint32 am = tst_store->value(at).date;
+    const qint32 bm = tst_store->value(bt).date;
+    if(!am || !bm)
+        return at > bt;
+
+    return am > bm;
+}
+
+static bool flatDialogLessThan(qint64 a, qint64 b)
+{
+    const qint64 at = tst_topMessages->value(a);
+    const qint64 bt = tst_topMessages->value(b);
+    const qint32 am = tst_dates->value(at);
+    const qint32 bm = tst_dates->value(bt);
+    if(!am || !bm)
+        return at > bt;
+
+    return am > bm;
+}
+
+static qint64 randomKey()
+{
+    const qint64 high = qrand();
+    const qint64 low = qrand();
+    const qint64 key = (high << 32) ^ low;
+    return (qrand() & 1)? key : -key;
+}
+
+static QList<qint64> randomKeys(int count)
+{
+    QList<qint64> result;
+    result.reserve(count);
+    for(int i=0; i<count; i++)
+        result << randomKey();
+    return result;
+}
+
+class TestTqFlatHash : public QObject
+{
+    Q_OBJECT
+public:
+    TestTqFlatHash(QObject *parent = 0);
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void insertLookup();
+    void randomOperations();
+    void rehash();
+    void collidingKeys();
+    void operatorIndex();
+    void takeAndClear();
+    void keysValues();
+    void dialogSort();
+    void lookupSpeedup();
+
+    void benchmarkLookup_data();
+    void benchmarkLookup();
+    void benchmarkInsert_data();
+    void benchmarkInsert();
+    void benchmarkDialogSort_data();
+    void benchmarkDialogSort();
+
+private:
+    void prepareDialogs(int dialogsCount, QHash<qint64,TstMessage> &store,
+                        TqFlatHash<qint32> &dates, QHash<qint64,qint64> &topMessages);
+    template<typename H>
+    qint64 lookupTime(const H &hash, const QList<qint64> &keys, qint64 &sum);
+};
+
+TestTqFlatHash::TestTqFlatHash(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void TestTqFlatHash::initTestCase()
+{
+    qsrand(0x5EED);
+}
+
+void TestTqFlatHash::insertLookup()
+{
+    QHash<qint64,int> hash;
+    TqFlatHash<int> flat;
+    QVERIFY(flat.isEmpty());
+
+    const QList<qint64> &keys = randomKeys(5000);
+    for(int i=0; i<keys.count(); i++)
+    {
+        hash.insert(keys.at(i), i);
+        flat.insert(keys.at(i), i);
+    }
+
+    QCOMPARE(flat.count(), hash.count());
+    QCOMPARE(flat.size(), hash.size());
+    Q_FOREACH(qint64 key, keys)
+    {
+        QVERIFY(flat.contains(key));
+        QCOMPARE(flat.value(key), hash.value(key));
+    }
+
+    for(int i=0; i<1000; i++)
+    {
+        const qint64 key = randomKey();
+        QCOMPARE(flat.contains(key), hash.contains(key));
+        QCOMPARE(flat.value(key, -1), hash.value(key, -1));
+    }
+}
+
+void TestTqFlatHash::randomOperations()
+{
+    /*! A small key range, so removals hit present keys and the
+     *  backward shift runs through long probe chains !*/
+    QHash<qint64,int> hash;
+    TqFlatHash<int> flat;
+    for(int i=0; i<200000; i++)
+    {
+        const qint64 key = qrand() % 3000 - 1500;
+        switch(qrand() % 4)
+        {
+        case 0:
+        case 1:
+            hash.insert(key, i);
+            flat.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(flat.remove(key), hash.remove(key));
+            break;
+        case 3:
+            QCOMPARE(flat.take(key), hash.take(key));
+            break;
+        }
+
+        QCOMPARE(flat.count(), hash.count());
+        const qint64 probe = qrand() % 3000 - 1500;
+        QCOMPARE(flat.contains(probe), hash.contains(probe));
+        QCOMPARE(flat.value(probe, -1), hash.value(probe, -1));
+    }
+
+    QHashIterator<qint64,int> i(hash);
+    while(i.hasNext())
+    {
+        i.next();
+        QCOMPARE(flat.value(i.key(), -1), i.value());
+    }
+}
+
+void TestTqFlatHash::rehash()
+{
+    /*! The table starts at 16 nodes and doubles past 3/4 load, check
+     *  everything right after each growth step !*/
+    TqFlatHash<qint64> flat;
+    int grown = 13;
+    for(qint64 key=0; key<100000; key++)
+    {
+        flat.insert(key, key*7);
+        if(flat.count() != grown)
+            continue;
+
+        for(qint64 k=0; k<=key; k++)
+            QCOMPARE(flat.value(k, -1), k*7);
+        grown = (grown-1)*2 + 1;
+    }
+
+    QCOMPARE(flat.count(), 100000);
+    for(qint64 key=0; key<100000; key+=2)
+        QCOMPARE(flat.remove(key), 1);
+
+    QCOMPARE(flat.count(), 50000);
+    for(qint64 key=0; key<100000; key++)
+        QCOMPARE(flat.value(key, -1), key%2? key*7 : -1);
+}
+
+void TestTqFlatHash::collidingKeys()
+{
+    /*! Keys differing only in the high bits !*/
+    QHash<qint64,int> hash;
+    TqFlatHash<int> flat;
+    for(int i=0; i<4000; i++)
+    {
+        const qint64 key = static_cast<qint64>(i) << 40;
+        hash.insert(key, i);
+        flat.insert(key, i);
+    }
+    for(int i=0; i<4000; i+=3)
+    {
+        const qint64 key = static_cast<qint64>(i) << 40;
+        QCOMPARE(flat.remove(key), hash.remove(key));
+    }
+
+    QCOMPARE(flat.count(), hash.count());
+    for(int i=0; i<4000; i++)
+    {
+        const qint64 key = static_cast<qint64>(i) << 40;
+        QCOMPARE(flat.value(key, -1), hash.value(key, -1));
+    }
+}
+
+void TestTqFlatHash::operatorIndex()
+{
+    TqFlatHash<int> flat;
+    QCOMPARE(flat[10], 0);
+    QCOMPARE(flat.count(), 1);
+
+    flat[10] += 5;
+    flat[-10] = 3;
+    QCOMPARE(flat.value(10), 5);
+    QCOMPARE(flat.value(-10), 3);
+    QCOMPARE(flat.count(), 2);
+}
+
+void TestTqFlatHash::takeAndClear()
+{
+    TqFlatHash<QString> flat;
+    flat.insert(1, "one");
+    flat.insert(2, "two");
+
+    QCOMPARE(flat.take(1), QString("one"));
+    QCOMPARE(flat.take(1), QString());
+    QCOMPARE(flat.remove(1), 0);
+    QCOMPARE(flat.count(), 1);
+
+    flat.clear();
+    QVERIFY(flat.isEmpty());
+    QVERIFY(!flat.contains(2));
+
+    flat.insert(2, "again");
+    QCOMPARE(flat.value(2), QString("again"));
+}
+
+void TestTqFlatHash::keysValues()
+{
+    QHash<qint64,qint64> hash;
+    TqFlatHash<qint64> flat;
+    Q_FOREACH(qint64 key, randomKeys(3000))
+    {
+        hash.insert(key, key/3);
+        flat.insert(key, key/3);
+    }
+
+    QList<qint64> flatKeys = flat.keys();
+    QList<qint64> hashKeys = hash.keys();
+    qSort(flatKeys);
+    qSort(hashKeys);
+    QCOMPARE(flatKeys, hashKeys);
+
+    QList<qint64> flatValues = flat.values();
+    QList<qint64> hashValues = hash.values();
+    qSort(flatValues);
+    qSort(hashValues);
+    QCOMPARE(flatValues, hashValues);
+}
+
+void TestTqFlatHash::prepareDialogs(int dialogsCount, QHash<qint64,TstMessage> &store,
+                                    TqFlatHash<qint32> &dates, QHash<qint64,qint64> &topMessages)
+{
+    for(int i=0; i<dialogsCount; i++)
+    {
+        const qint64 dialogId = randomKey();
+        const qint64 msgId = i+1;
+        topMessages.insert(dialogId, msgId);
+
+        /*! Some top messages aren't stored, like in the real cache !*/
+        if(qrand() % 10 == 0)
+            continue;
+
+        TstMessage msg;
+        msg.date = 1400000000 + qrand() % 100000;
+        msg.text = QString("message %1").arg(msgId);
+        msg.payload = QByteArray(64, 'x');
+        store.insert(msgId, msg);
+        dates.insert(msgId, msg.date);
+    }
+}
+
+void TestTqFlatHash::dialogSort()
+{
+    QHash<qint64,TstMessage> store;
+    TqFlatHash<qint32> dates;
+    QHash<qint64,qint64> topMessages;
+    prepareDialogs(3000, store, dates, topMessages);
+
+    tst_store = &store;
+    tst_dates = &dates;
+    tst_topMessages = &topMessages;
+
+    QList<qint64> byStore = topMessages.keys();
+    QList<qint64> byDates = byStore;
+    qStableSort(byStore.begin(), byStore.end(), storeDialogLessThan);
+    qStableSort(byDates.begin(), byDates.end(), flatDialogLessThan);
+    QCOMPARE(byDates, byStore);
+
+    for(int i=1; i<byDates.count(); i++)
+        QVERIFY(!flatDialogLessThan(byDates.at(i), byDates.at(i-1)));
+}
+
+template<typename H>
+qint64 TestTqFlatHash::lookupTime(const H &hash, const QList<qint64> &keys, qint64 &sum)
+{
+    qint64 best = -1;
+    for(int run=0; run<7; run++)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for(int i=0; i<keys.count(); i++)
+            sum += hash.value(keys.at(i));
+
+        const qint64 elapsed = timer.nsecsElapsed();
+        if(best == -1 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+void TestTqFlatHash::lookupSpeedup()
+{
+    /*! The comparators only look up dates, so that's the path that has
+     *  to be faster than the QHash it replaced !*/
+    QHash<qint64,qint32> hash;
+    TqFlatHash<qint32> flat;
+    const QList<qint64> &keys = randomKeys(200000);
+    for(int i=0; i<keys.count(); i++)
+    {
+        hash.insert(keys.at(i), i);
+        flat.insert(keys.at(i), i);
+    }
+
+    QList<qint64> probes = keys;
+    std::random_shuffle(probes.begin(), probes.end());
+
+    qint64 hashSum = 0;
+    qint64 flatSum = 0;
+    const qint64 hashTime = lookupTime(hash, probes, hashSum);
+    const qint64 flatTime = lookupTime(flat, probes, flatSum);
+    QCOMPARE(flatSum, hashSum);
+
+    qDebug() << __FUNCTION__ << "QHash:" << hashTime << "ns TqFlatHash:" << flatTime << "ns";
+    QVERIFY2(flatTime <= hashTime, "TqFlatHash lookups are slower than QHash");
+}
+
+void TestTqFlatHash::benchmarkLookup_data()
+{
+    QTest::addColumn<bool>("flat");
+    QTest::newRow("QHash") << false;
+    QTest::newRow("TqFlatHash") << true;
+}
+
+void TestTqFlatHash::benchmarkLookup()
+{
+    QFETCH(bool, flat);
+
+    QHash<qint64,qint32> hash;
+    TqFlatHash<qint32> flatHash;
+    const QList<qint64> &keys = randomKeys(100000);
+    for(int i=0; i<keys.count(); i++)
+    {
+        hash.insert(keys.at(i), i);
+        flatHash.insert(keys.at(i), i);
+    }
+
+    qint64 sum = 0;
+    if(flat)
+    {
+        QBENCHMARK {
+            for(int i=0; i<keys.count(); i++)
+                sum += flatHash.value(keys.at(i));
+        }
+    }
+    else
+    {
+        QBENCHMARK {
+            for(int i=0; i<keys.count(); i++)
+                sum += hash.value(keys.at(i));
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+void TestTqFlatHash::benchmarkInsert_data()
+{
+    benchmarkLookup_data();
+}
+
+void TestTqFlatHash::benchmarkInsert()
+{
+    QFETCH(bool, flat);
+
+    const QList<qint64> &keys = randomKeys(100000);
+    if(flat)
+    {
+        QBENCHMARK {
+            TqFlatHash<qint32> flatHash;
+            for(int i=0; i<keys.count(); i++)
+                flatHash.insert(keys.at(i), i);
+        }
+    }
+    else
+    {
+        QBENCHMARK {
+            QHash<qint64,qint32> hash;
+            for(int i=0; i<keys.count(); i++)
+                hash.insert(keys.at(i), i);
+        }
+    }
+}
+
+void TestTqFlatHash::benchmarkDialogSort_data()
+{
+    benchmarkLookup_data();
+}
+
+void TestTqFlatHash::benchmarkDialogSort()
+{
+    QFETCH(bool, flat);
+
+    QHash<qint64,TstMessage> store;
+    TqFlatHash<qint32> dates;
+    QHash<qint64,qint64> topMessages;
+    prepareDialogs(5000, store, dates, topMessages);
+
+    tst_store = &store;
+    tst_dates = &dates;
+    tst_topMessages = &topMessages;
+
+    const QList<qint64> &dialogs = topMessages.keys();
+    QBENCHMARK {
+        QList<qint64> list = dialogs;
+        qStableSort(list.begin(), list.end(), flat? flatDialogLessThan : storeDialogLessThan);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestTqFlatHash)
+
+#include "tst_tqflathash.moc"
@@ -2,6 +2,37 @@
 
 #include <QHash>
 
+/*! roleNames() is fixed per model class, so the derived tables are built
+ *  once per class and shared by all of its instances !*/
+class TgAbstractListModelRoles
+{
+public:
+    QStringList names;
+    QHash<QByteArray,int> ids;
+};
+
+static QHash<const QMetaObject*, TgAbstractListModelRoles> tg_abstract_list_model_roles;
+
+static const TgAbstractListModelRoles &tgAbstractListModelRoles(const TgAbstractListModel *model)
+{
+    QHash<const QMetaObject*, TgAbstractListModelRoles>::iterator i = tg_abstract_list_model_roles.find(model->metaObject());
+    if(i != tg_abstract_list_model_roles.end())
+        return i.value();
+
+    TgAbstractListModelRoles roles;
+    const QHash<int,QByteArray> &roleNames = model->roleNames();
+    QHashIterator<int,QByteArray> j(roleNames);
+    while(j.hasNext())
+    {
+        j.next();
+        roles.names << j.value();
+        roles.ids[j.value()] = j.key();
+    }
+
+    qSort(roles.names.begin(), roles.names.end());
+    return tg_abstract_list_model_roles.insert(model->metaObject(), roles).value();
+}
+
 TgAbstractListModel::TgAbstractListModel(QObject *parent) :
     QAbstractListModel(parent)
 {
@@ -9,17 +40,12 @@ TgAbstractListModel::TgAbstractListModel(QObject *parent) :
 
 QStringList TgAbstractListModel::roles() const
 {
-    QStringList result;
-    const QHash<int,QByteArray> &roles = roleNames();
-    QHashIterator<int,QByteArray> i(roles);
-    while(i.hasNext())
-    {
-        i.next();
-        result << i.value();
-    }
+    return tgAbstractListModelRoles(this).names;
+}
 
-    qSort(result.begin(), result.end());
-    return result;
+const QHash<QByteArray, int> &TgAbstractListModel::roleIds() const
+{
+    return tgAbstractListModelRoles(this).ids;
 }
 
 QVariant TgAbstractListModel::get(int row, int role) const
@@ -37,18 +63,49 @@ QVariantMap TgAbstractListModel::get(int index) const
         return QVariantMap();
 
     QVariantMap result;
-    const QHash<int,QByteArray> &roles = roleNames();
-    QHashIterator<int,QByteArray> i(roles);
+    const QModelIndex &idx = QAbstractListModel::index(index,0);
+    const QHash<QByteArray,int> &ids = roleIds();
+    QHashIterator<QByteArray,int> i(ids);
     while(i.hasNext())
     {
         i.next();
-        result[i.value()] = get(index, i.key());
+        result[i.key()] = data(idx, i.value());
     }
 
     return result;
 }
 
-TgAbstractListModel::~TgAbstractListModel()
+/*! Returns one list of values per row, in the order of "roles" (all roles,
+ *  sorted by name, when empty). Meant for QML code walking many rows. !*/
+QVariantList TgAbstractListModel::getRange(int from, int count, const QStringList &roles) const
 {
+    QVariantList result;
+    const int to = qMin(from+count, rowCount());
+    if(from < 0 || from >= to)
+        return result;
+
+    const QHash<QByteArray,int> &ids = roleIds();
+    const QStringList &names = roles.isEmpty()? TgAbstractListModel::roles() : roles;
+    QVector<int> columns;
+    columns.reserve(names.count());
+    Q_FOREACH(const QString &name, names)
+        columns << ids.value(name.toUtf8(), -1);
+
+    result.reserve(to-from);
+    for(int row=from; row<to; row++)
+    {
+        const QModelIndex &idx = index(row,0);
+        QVariantList values;
+        values.reserve(columns.count());
+        Q_FOREACH(int role, columns)
+            values << (role == -1? QVariant() : data(idx, role));
+
+        result << QVariant(values);
+    }
+
+    return result;
 }
 
+TgAbstractListModel::~TgAbstractListModel()
+{
+}
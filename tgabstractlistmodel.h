@@ -3,6 +3,11 @@
 
 #include <QAbstractListModel>
 #include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+#include <algorithm>
 
 #include "telegramqml_global.h"
 
@@ -18,6 +23,152 @@ public:
 public Q_SLOTS:
     QVariant get(int index, int role) const;
     QVariantMap get(int index) const;
+    QVariantList getRange(int from, int count, const QStringList &roles = QStringList()) const;
+
+protected:
+    const QHash<QByteArray,int> &roleIds() const;
+
+    template<typename T>
+    void syncList(QList<T> &current, const QList<T> &list, QList<T> *removed = 0, QList<int> *inserted = 0);
 };
 
+/*! Turns "current" into "list" emitting grouped remove, move and insert
+ *  signals. Items must be unique in both lists. Items on the longest
+ *  increasing subsequence of the surviving rows never move, so every other
+ *  row is moved exactly once. Removed items and the final rows of inserted
+ *  items are reported back for callers that have per item bookkeeping. !*/
+template<typename T>
+void TgAbstractListModel::syncList(QList<T> &current, const QList<T> &list, QList<T> *removed, QList<int> *inserted)
+{
+    QSet<T> target;
+    target.reserve(list.count());
+    Q_FOREACH(const T &item, list)
+        target.insert(item);
+
+    /*! Remove runs of rows that are not in the new list, bottom up so the
+     *  indexes of the rows above stay valid !*/
+    for(int i=current.count()-1; i>=0; i--)
+    {
+        if(target.contains(current.at(i)))
+            continue;
+
+        int first = i;
+        while(first > 0 && !target.contains(current.at(first-1)))
+            first--;
+
+        if(removed)
+            for(int j=first; j<=i; j++)
+                removed->prepend(current.at(j));
+
+        beginRemoveRows(QModelIndex(), first, i);
+        current.erase(current.begin()+first, current.begin()+i+1);
+        endRemoveRows();
+        i = first;
+    }
+
+    /*! Row of every surviving item, kept up to date as blocks move !*/
+    QHash<T,int> position;
+    position.reserve(current.count());
+    for(int i=0; i<current.count(); i++)
+        position[current.at(i)] = i;
+
+    QList<T> kept;
+    QHash<T,int> rank;
+    kept.reserve(current.count());
+    rank.reserve(current.count());
+    Q_FOREACH(const T &item, list)
+        if(position.contains(item))
+        {
+            rank[item] = kept.count();
+            kept << item;
+        }
+
+    /*! Longest increasing subsequence of the target ranks, O(n log n) !*/
+    const int n = current.count();
+    QVector<int> seq(n), tails, tailIdx, prev(n, -1);
+    for(int i=0; i<n; i++)
+    {
+        seq[i] = rank.value(current.at(i));
+        const int pos = std::lower_bound(tails.begin(), tails.end(), seq[i]) - tails.begin();
+        if(pos == tails.count())
+        {
+            tails << seq[i];
+            tailIdx << i;
+        }
+        else
+        {
+            tails[pos] = seq[i];
+            tailIdx[pos] = i;
+        }
+        prev[i] = pos? tailIdx.at(pos-1) : -1;
+    }
+
+    QVector<bool> stable(n, false);
+    for(int i=tailIdx.isEmpty()? -1 : tailIdx.last(); i != -1; i = prev.at(i))
+        stable[seq.at(i)] = true;
+
+    /*! Place the other rows in target order, each one right after its
+     *  predecessor. Rows that are neighbours both before and after the
+     *  move travel together. !*/
+    for(int r=0; r<kept.count(); r++)
+    {
+        if(stable.at(r))
+            continue;
+
+        const int from = position.value(kept.at(r));
+        int len = 1;
+        while(r+len < kept.count() && !stable.at(r+len) &&
+              from+len < current.count() && current.at(from+len) == kept.at(r+len))
+            len++;
+
+        const int to = r? position.value(kept.at(r-1))+1 : 0;
+        r += len-1;
+        if(from <= to && to <= from+len)
+            continue;
+
+        /*! Rotating in place only touches the rows between the two ends !*/
+        beginMoveRows(QModelIndex(), from, from+len-1, QModelIndex(), to);
+        int first, last;
+        if(to > from)
+        {
+            std::rotate(current.begin()+from, current.begin()+from+len, current.begin()+to);
+            first = from;
+            last = to;
+        }
+        else
+        {
+            std::rotate(current.begin()+to, current.begin()+from, current.begin()+from+len);
+            first = to;
+            last = from+len;
+        }
+        for(int j=first; j<last; j++)
+            position[current.at(j)] = j;
+        endMoveRows();
+    }
+
+    /*! Surviving rows now have the target order, insert the new runs !*/
+    for(int i=0; i<list.count(); i++)
+    {
+        if(position.contains(list.at(i)))
+            continue;
+
+        int last = i;
+        while(last+1 < list.count() && !position.contains(list.at(last+1)))
+            last++;
+
+        /*! Append the run and rotate it into place in one pass !*/
+        beginInsertRows(QModelIndex(), i, last);
+        const int end = current.count();
+        for(int j=i; j<=last; j++)
+        {
+            current.append(list.at(j));
+            if(inserted)
+                inserted->append(j);
+        }
+        std::rotate(current.begin()+i, current.begin()+end, current.end());
+        endInsertRows();
+        i = last;
+    }
+}
+
 #endif // TGABSTRACTLISTMODEL_H
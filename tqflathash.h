@@ -0,0 +1,177 @@
+#ifndef TQFLATHASH_H
+#define TQFLATHASH_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QList>
+
+/*! Open addressing qint64 -> T table with linear probing. All nodes live
+ *  in one contiguous array, so a lookup touches a couple of cache lines
+ *  instead of chasing QHash nodes. Removal shifts the following nodes
+ *  back, so there are no tombstones to skip. !*/
+template<typename T>
+class TqFlatHash
+{
+    struct Node
+    {
+        Node(): key(0), value(), used(false) {}
+        qint64 key;
+        T value;
+        bool used;
+    };
+
+public:
+    TqFlatHash(): _count(0) {}
+
+    int count() const { return _count; }
+    int size() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+
+    void clear()
+    {
+        _nodes.clear();
+        _count = 0;
+    }
+
+    bool contains(qint64 key) const
+    {
+        return find(key) != -1;
+    }
+
+    T value(qint64 key, const T &defaultValue = T()) const
+    {
+        const int i = find(key);
+        return i == -1? defaultValue : _nodes.at(i).value;
+    }
+
+    void insert(qint64 key, const T &value)
+    {
+        const int i = findOrInsert(key);
+        _nodes[i].value = value;
+    }
+
+    T &operator[](qint64 key)
+    {
+        return _nodes[findOrInsert(key)].value;
+    }
+
+    int remove(qint64 key)
+    {
+        const int i = find(key);
+        if(i == -1)
+            return 0;
+
+        erase(i);
+        return 1;
+    }
+
+    T take(qint64 key)
+    {
+        const int i = find(key);
+        if(i == -1)
+            return T();
+
+        const T result = _nodes.at(i).value;
+        erase(i);
+        return result;
+    }
+
+    QList<qint64> keys() const
+    {
+        QList<qint64> result;
+        result.reserve(_count);
+        for(int i=0; i<_nodes.size(); i++)
+            if(_nodes.at(i).used)
+                result << _nodes.at(i).key;
+        return result;
+    }
+
+    QList<T> values() const
+    {
+        QList<T> result;
+        result.reserve(_count);
+        for(int i=0; i<_nodes.size(); i++)
+            if(_nodes.at(i).used)
+                result << _nodes.at(i).value;
+        return result;
+    }
+
+private:
+    int slotOf(qint64 key) const
+    {
+        quint64 h = static_cast<quint64>(key) * Q_UINT64_C(0x9E3779B97F4A7C15);
+        return static_cast<int>(h >> 32) & (_nodes.size()-1);
+    }
+
+    int find(qint64 key) const
+    {
+        if(_nodes.isEmpty())
+            return -1;
+
+        const int mask = _nodes.size()-1;
+        const Node *nodes = _nodes.constData();
+        for(int i=slotOf(key); nodes[i].used; i = (i+1) & mask)
+            if(nodes[i].key == key)
+                return i;
+
+        return -1;
+    }
+
+    int findOrInsert(qint64 key)
+    {
+        if((_count+1)*4 > _nodes.size()*3)
+            rehash(_nodes.isEmpty()? 16 : _nodes.size()*2);
+
+        const int mask = _nodes.size()-1;
+        int i = slotOf(key);
+        for(; _nodes.at(i).used; i = (i+1) & mask)
+            if(_nodes.at(i).key == key)
+                return i;
+
+        Node &node = _nodes[i];
+        node.key = key;
+        node.value = T();
+        node.used = true;
+        _count++;
+        return i;
+    }
+
+    void erase(int i)
+    {
+        const int mask = _nodes.size()-1;
+        int j = i;
+        while(true)
+        {
+            j = (j+1) & mask;
+            if(!_nodes.at(j).used)
+                break;
+
+            /*! Move the node back if its home slot doesn't lie in (i, j] !*/
+            const int k = slotOf(_nodes.at(j).key);
+            const bool inRange = (i <= j)? (i < k && k <= j) : (i < k || k <= j);
+            if(inRange)
+                continue;
+
+            _nodes[i] = _nodes.at(j);
+            i = j;
+        }
+
+        _nodes[i] = Node();
+        _count--;
+    }
+
+    void rehash(int capacity)
+    {
+        QVector<Node> old = _nodes;
+        _nodes = QVector<Node>(capacity);
+        _count = 0;
+        for(int i=0; i<old.size(); i++)
+            if(old.at(i).used)
+                _nodes[findOrInsert(old.at(i).key)].value = old.at(i).value;
+    }
+
+    QVector<Node> _nodes;
+    int _count;
+};
+
+#endif // TQFLATHASH_H
@@ -6,14 +6,14 @@
 
 #define tqobject_cast(OBJECT) static_cast<TqObject*>(OBJECT)
 
+/*! Use QPointer<T> to hold TqObjects that may die under you. It's a
+ *  weak reference, so validity checks cost no global bookkeeping. !*/
 class TELEGRAMQMLSHARED_EXPORT TqObject : public QObject
 {
     Q_OBJECT
 public:
     Q_INVOKABLE explicit TqObject(QObject *parent = 0);
     ~TqObject();
-
-    static bool isValid(TqObject *obj);
 };
 
 #endif // TQOBJECT_H
@@ -1,3 +1,5 @@
+#define USERNAME_FILTER_LIMIT 50
+
 #include "usernamefiltermodel.h"
 #include "telegramqml.h"
 #include "objects/types.h"
@@ -12,12 +14,14 @@ public:
 
     QList<qint64> list;
     QString keyword;
+    int limit;
 };
 
 UserNameFilterModel::UserNameFilterModel(QObject *parent) :
     TgAbstractListModel(parent)
 {
     p = new UserNameFilterModelPrivate;
+    p->limit = USERNAME_FILTER_LIMIT;
 }
 
 TelegramQml *UserNameFilterModel::telegram() const
@@ -32,11 +36,11 @@ void UserNameFilterModel::setTelegram(TelegramQml *tgo)
         return;
 
     if(p->telegram)
-        disconnect(p->telegram, SIGNAL(chatFullsChanged()), this, SLOT(refresh()));
+        disconnect(p->telegram, SIGNAL(chatParticipantsChanged(qint64)), this, SLOT(chatParticipantsChanged(qint64)));
 
     p->telegram = tg;
     if(p->telegram)
-        connect(p->telegram, SIGNAL(chatFullsChanged()), this, SLOT(refresh()));
+        connect(p->telegram, SIGNAL(chatParticipantsChanged(qint64)), this, SLOT(chatParticipantsChanged(qint64)));
 
     Q_EMIT telegramChanged();
     listChanged();
@@ -116,6 +120,22 @@ QString UserNameFilterModel::keyword() const
     return p->keyword;
 }
 
+void UserNameFilterModel::setLimit(int limit)
+{
+    if(p->limit == limit)
+        return;
+
+    p->limit = limit;
+    Q_EMIT limitChanged();
+
+    listChanged();
+}
+
+int UserNameFilterModel::limit() const
+{
+    return p->limit;
+}
+
 void UserNameFilterModel::refresh()
 {
     listChanged();
@@ -129,86 +149,37 @@ qint64 UserNameFilterModel::get(int idx)
     return p->list.at(idx);
 }
 
+void UserNameFilterModel::chatParticipantsChanged(qint64 chatId)
+{
+    if(!p->dialog || p->dialog->peer()->chatId() != chatId)
+        return;
+
+    listChanged();
+}
+
 void UserNameFilterModel::listChanged()
 {
     QList<qint64> list;
     if(p->telegram)
-        list = p->telegram->userIndex(p->keyword);
-
-    QList<qint64> dialogList;
-    if(p->telegram && p->dialog)
     {
-        qint64 chatId = p->dialog->peer()->chatId();
-        if(chatId)
+        QSet<qint64> scope;
+        if(p->dialog)
         {
-            ChatFullObject *chatFull = p->telegram->chatFull(chatId);
-            if(chatFull)
-                dialogList = chatFull->participants()->participants()->userIds();
+            qint64 chatId = p->dialog->peer()->chatId();
+            if(chatId)
+            {
+                scope = p->telegram->chatParticipants(chatId);
+                if(scope.isEmpty())
+                    p->telegram->messagesGetFullChat(chatId);
+            }
             else
-                p->telegram->messagesGetFullChat(chatId);
-        }
-        else
-            dialogList << p->dialog->peer()->userId();
-    }
-
-    if(!dialogList.isEmpty())
-        for( int i=0 ; i<list.count() ; i++ )
-        {
-            const qint64 uId = list.at(i);
-            if( dialogList.contains(uId) )
-                continue;
-
-            list.removeAt(i);
-            i--;
+                scope << p->dialog->peer()->userId();
         }
 
-    for( int i=0 ; i<p->list.count() ; i++ )
-    {
-        const qint64 uId = p->list.at(i);
-        if( list.contains(uId) )
-            continue;
-
-        beginRemoveRows(QModelIndex(), i, i);
-        p->list.removeAt(i);
-        i--;
-        endRemoveRows();
+        list = p->telegram->userIndex(p->keyword, scope, p->limit);
     }
 
-
-    QList<qint64> temp_list = list;
-    for( int i=0 ; i<temp_list.count() ; i++ )
-    {
-        const qint64 uId = temp_list.at(i);
-        if( p->list.contains(uId) )
-            continue;
-
-        temp_list.removeAt(i);
-        i--;
-    }
-    while( p->list != temp_list )
-        for( int i=0 ; i<p->list.count() ; i++ )
-        {
-            const qint64 uId = p->list.at(i);
-            int nw = temp_list.indexOf(uId);
-            if( i == nw )
-                continue;
-
-            beginMoveRows( QModelIndex(), i, i, QModelIndex(), nw>i?nw+1:nw );
-            p->list.move( i, nw );
-            endMoveRows();
-        }
-
-
-    for( int i=0 ; i<list.count() ; i++ )
-    {
-        const qint64 uId = list.at(i);
-        if( p->list.contains(uId) )
-            continue;
-
-        beginInsertRows(QModelIndex(), i, i );
-        p->list.insert( i, uId );
-        endInsertRows();
-    }
+    syncList(p->list, list);
 
     Q_EMIT countChanged();
 }
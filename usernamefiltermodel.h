@@ -15,6 +15,7 @@ class TELEGRAMQMLSHARED_EXPORT UserNameFilterModel : public TgAbstractListModel
     Q_PROPERTY(TelegramQml* telegram READ telegram WRITE setTelegram NOTIFY telegramChanged)
     Q_PROPERTY(DialogObject* dialog READ dialog WRITE setDialog NOTIFY dialogChanged)
     Q_PROPERTY(QString keyword READ keyword WRITE setKeyword NOTIFY keywordChanged)
+    Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY limitChanged)
     Q_PROPERTY(int count READ count NOTIFY countChanged)
 
 public:
@@ -43,6 +44,9 @@ public:
     void setKeyword(const QString &keyword);
     QString keyword() const;
 
+    void setLimit(int limit);
+    int limit() const;
+
 public Q_SLOTS:
     void refresh();
     qint64 get(int idx);
@@ -51,10 +55,12 @@ Q_SIGNALS:
     void telegramChanged();
     void countChanged();
     void keywordChanged();
+    void limitChanged();
     void dialogChanged();
 
 private Q_SLOTS:
     void listChanged();
+    void chatParticipantsChanged(qint64 chatId);
 
 private:
     UserNameFilterModelPrivate *p;